@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include "binary/binary.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+TEST_CASE("::binary")
+{
+    using namespace std;
+    using namespace eds::binary;
+
+    SECTION("Zig Zag")
+    {
+        REQUIRE(EncodeZigZag(0) == 0);
+        REQUIRE(EncodeZigZag(-1) == 1);
+        REQUIRE(EncodeZigZag(1) == 2);
+        REQUIRE(EncodeZigZag(-2) == 3);
+        REQUIRE(EncodeZigZag(numeric_limits<int64_t>::max()) == numeric_limits<uint64_t>::max() - 1);
+        REQUIRE(EncodeZigZag(numeric_limits<int64_t>::min()) == numeric_limits<uint64_t>::max());
+
+        for (int64_t x : {int64_t{0}, int64_t{-1}, int64_t{1}, int64_t{-300}, int64_t{300},
+                          numeric_limits<int64_t>::max(), numeric_limits<int64_t>::min()})
+        {
+            REQUIRE(DecodeZigZag(EncodeZigZag(x)) == x);
+        }
+    }
+
+    SECTION("Varint")
+    {
+        BinaryWriter writer;
+        writer.WriteVarint(0);
+        writer.WriteVarint(127);
+        writer.WriteVarint(128);
+        writer.WriteVarint(300);
+        REQUIRE(writer.Buffer() == MemoryBuffer{0x00, 0x7F, 0x80, 0x01, 0xAC, 0x02});
+
+        vector<uint64_t> values = {0, 1, 127, 128, 16383, 16384, 1ULL << 35, numeric_limits<uint64_t>::max()};
+        writer.Clear();
+        for (auto x : values)
+        {
+            writer.WriteVarint(x);
+        }
+        writer.WriteSignedVarint(-1);
+        writer.WriteSignedVarint(numeric_limits<int64_t>::min());
+
+        BinaryReader reader{writer.Export()};
+        for (auto x : values)
+        {
+            REQUIRE(reader.ReadVarint() == x);
+        }
+        REQUIRE(reader.ReadSignedVarint() == -1);
+        REQUIRE(reader.ReadSignedVarint() == numeric_limits<int64_t>::min());
+        REQUIRE_THROWS(reader.ReadVarint());
+    }
+
+    SECTION("Invalid Varint")
+    {
+        // truncated
+        BinaryReader reader{MemoryBuffer{0x80, 0x80}};
+        REQUIRE_THROWS(reader.ReadVarint());
+
+        // longer than kMaxVarintSize bytes
+        reader.Import(MemoryBuffer(kMaxVarintSize + 1, 0x80));
+        REQUIRE_THROWS(reader.ReadVarint());
+
+        // bits beyond 64 in the last byte
+        MemoryBuffer overflow(kMaxVarintSize - 1, 0xFF);
+        overflow.push_back(0x02);
+        reader.Import(overflow);
+        REQUIRE_THROWS(reader.ReadVarint());
+
+        overflow.back() = 0x01;
+        reader.Import(overflow);
+        REQUIRE(reader.ReadVarint() == numeric_limits<uint64_t>::max());
+    }
+}
@@ -0,0 +1,132 @@
+#include "catch.hpp"
+#include "binary/bit-codes.h"
+#include <random>
+#include <vector>
+
+TEST_CASE("::bit-codes")
+{
+    using namespace std;
+    using Reader = eds::BitReader<const uint8_t*>;
+
+    random_device rd;
+    default_random_engine gen{rd()};
+
+    // small values and values of every bit length
+    vector<uint32_t> values;
+    for (uint32_t x = 1; x <= 100; ++x)
+    {
+        values.push_back(x);
+    }
+    for (int n = 0; n < 32; ++n)
+    {
+        values.push_back(1U << n);
+        values.push_back((1U << n) | (static_cast<uint32_t>(gen()) & ((1U << n) - 1)));
+    }
+    values.push_back(~uint32_t{0});
+
+    SECTION("Elias Gamma")
+    {
+        eds::BitEmitter emit;
+        eds::WriteEliasGamma(emit, 1);
+        eds::WriteEliasGamma(emit, 2);
+        eds::WriteEliasGamma(emit, 5);
+        // 1 010 00101
+        REQUIRE(emit.Export() == vector<uint8_t>{0xA2, 0x80});
+
+        for (auto x : values)
+        {
+            eds::WriteEliasGamma(emit, x);
+        }
+
+        auto data = emit.Export();
+        Reader reader{data.data(), data.data() + data.size()};
+        for (auto x : values)
+        {
+            REQUIRE(eds::ReadEliasGamma(reader) == x);
+        }
+        REQUIRE_THROWS(eds::ReadEliasGamma(reader));
+    }
+
+    SECTION("Elias Delta")
+    {
+        eds::BitEmitter emit;
+        eds::WriteEliasDelta(emit, 1);
+        eds::WriteEliasDelta(emit, 10);
+        // 1 00100 010
+        REQUIRE(emit.Export() == vector<uint8_t>{0x91, 0x00});
+
+        for (auto x : values)
+        {
+            eds::WriteEliasDelta(emit, x);
+        }
+
+        auto data = emit.Export();
+        Reader reader{data.data(), data.data() + data.size()};
+        for (auto x : values)
+        {
+            REQUIRE(eds::ReadEliasDelta(reader) == x);
+        }
+    }
+
+    SECTION("Rice")
+    {
+        eds::BitEmitter emit;
+        eds::WriteRice(emit, 9, 2);
+        // 00 1 01
+        REQUIRE(emit.Export() == vector<uint8_t>{0x28});
+
+        for (int k : {0, 3, 7, 31})
+        {
+            vector<uint32_t> v = {0, 1, 2, 100, 1000};
+            for (auto x : values)
+            {
+                v.push_back(x >> (k < 20 ? 20 - k : 0));
+            }
+
+            for (auto x : v)
+            {
+                eds::WriteRice(emit, x, k);
+            }
+
+            auto data = emit.Export();
+            Reader reader{data.data(), data.data() + data.size()};
+            for (auto x : v)
+            {
+                REQUIRE(eds::ReadRice(reader, k) == x);
+            }
+        }
+
+        // unary part without its terminating one
+        vector<uint8_t> zeros(16);
+        Reader reader{zeros.data(), zeros.data() + zeros.size()};
+        REQUIRE_THROWS(eds::ReadRice(reader, 2));
+    }
+
+    SECTION("Truncated Input")
+    {
+        // each code takes more bits than the bytes kept, which must throw rather than read past them
+        auto truncate = [](vector<uint8_t> data, size_t size) {
+            data.resize(size);
+            return data;
+        };
+
+        eds::BitEmitter emit;
+        eds::WriteEliasGamma(emit, 1000); // 19 bits
+        auto data = truncate(emit.Export(), 2);
+        Reader gamma{data.data(), data.data() + data.size()};
+        REQUIRE_THROWS(eds::ReadEliasGamma(gamma));
+
+        eds::WriteEliasDelta(emit, 1000); // 7 bits of length and 9 bits of value
+        data = truncate(emit.Export(), 1);
+        Reader delta{data.data(), data.data() + data.size()};
+        REQUIRE_THROWS(eds::ReadEliasDelta(delta));
+
+        eds::WriteRice(emit, 1000, 7); // 8 bits of unary and 7 bits of remainder
+        data = truncate(emit.Export(), 1);
+        Reader rice{data.data(), data.data() + data.size()};
+        REQUIRE_THROWS(eds::ReadRice(rice, 7));
+
+        // the reader is intact after a failed read
+        REQUIRE(rice.RemainingSize() == 8);
+    }
+}
@@ -14,35 +14,169 @@ TEST_CASE("::bit-ops")
     default_random_engine gen{rd()};
     uniform_int_distribution<> dis_len{1, 31};
 
-    for (int i = 0; i < kTestEpoch; ++i)
+    SECTION("Random Round Trip")
     {
+        for (int i = 0; i < kTestEpoch; ++i)
+        {
+            vector<int> v_len;
+            vector<uint32_t> v_data;
+
+            for (auto i = 0; i < kTestScale; ++i)
+            {
+                auto len = dis_len(gen);
+                v_len.push_back(len);
+
+                uniform_int_distribution<> dis_byte{0, 1 << (len - 1)};
+                auto x = dis_byte(gen);
+                v_data.push_back(x);
+            }
+
+            eds::BitEmitter emit;
+            for (auto i = 0; i < kTestScale; ++i)
+            {
+                emit.Write(v_data[i], v_len[i]);
+            }
+            auto bin = emit.Export();
+
+            eds::BitReader<uint8_t*> reader(bin.data(), bin.data() + bin.size());
+            vector<uint32_t> result;
+            for (auto len : v_len)
+            {
+                result.push_back(reader.Read(len));
+            }
+
+            CHECK(result == v_data);
+
+            // refilled byte by byte for iterators other than pointers
+            eds::BitReader<vector<uint8_t>::const_iterator> iter_reader(bin.cbegin(), bin.cend());
+            vector<uint32_t> iter_result;
+            for (auto len : v_len)
+            {
+                iter_result.push_back(iter_reader.Read(len));
+            }
+
+            CHECK(iter_result == v_data);
+        }
+    }
+
+    SECTION("Full Width")
+    {
+        eds::BitEmitter emit;
+        emit.Write(1, 1);
+        emit.Write(0xdeadbeef, 32);
+        emit.Write(0xffffffff, 3);
+        emit.Write(0x12345678, 32);
+
+        // bits beyond len are ignored
+        CHECK(emit.Value() == vector<uint8_t>{0xef, 0x56, 0xdf, 0x77, 0xf1, 0x23, 0x45, 0x67, 0x80});
+
+        auto bin = emit.Export();
+        eds::BitReader<const uint8_t*> reader(bin.data(), bin.data() + bin.size());
+        CHECK(reader.Read(1) == 1);
+        CHECK(reader.Read(32) == 0xdeadbeef);
+        CHECK(reader.Read(3) == 7);
+        CHECK(reader.Read(32) == 0x12345678);
+    }
+
+    SECTION("Peek And Skip")
+    {
+        vector<uint8_t> bin = {0xab, 0xcd, 0xef, 0x01, 0x23, 0x45, 0x67, 0x89, 0xfe};
+        eds::BitReader<const uint8_t*> reader(bin.data(), bin.data() + bin.size());
+
+        CHECK(reader.RemainingSize() == 72);
+        CHECK(reader.Peek(4) == 0xa);
+        CHECK(reader.Peek(12) == 0xabc);
+        reader.Skip(4);
+        CHECK(reader.Offset() == 4);
+        CHECK(reader.Read(16) == 0xbcde);
+        reader.Skip(28);
+        CHECK(reader.Offset() == 0);
+        CHECK(reader.RemainingSize() == 24);
+        CHECK(reader.Read(16) == 0x6789);
+
+        // bits past the end read as zero
+        CHECK(reader.Peek(16) == 0xfe00);
+        CHECK(!reader.Exhausted());
+
+        reader.Skip(8);
+        CHECK(reader.Exhausted());
+
+        reader.Reset();
+        CHECK(reader.Read(8) == 0xab);
+    }
+
+    SECTION("Partial Value")
+    {
+        eds::BitEmitter emit;
+        emit.Write(0x5, 3);
+        CHECK(emit.CompleteSize() == 0);
+        CHECK(emit.Value() == vector<uint8_t>{0xa0});
+
+        // the padded byte is completed by following writes
+        emit.Write(0x1f, 5);
+        emit.Write(0x1, 2);
+        CHECK(emit.CompleteSize() == 1);
+        CHECK(emit.Value() == vector<uint8_t>{0xbf, 0x40});
+
+        emit.Drain(1);
+        CHECK(emit.Value() == vector<uint8_t>{0x40});
+
+        emit.Write(0x3f, 6);
+        CHECK(emit.Value() == vector<uint8_t>{0x7f});
+    }
+
+    SECTION("Lsb First")
+    {
+        eds::BasicBitEmitter<eds::LsbFirst> emit;
+        emit.Write(1, 1);
+        emit.Write(0x1, 2);
+        emit.Write(0x5, 3);
+        emit.Write(0xabc, 12);
+        emit.Write(0xdeadbeef, 32);
+        emit.Write(0x7f, 7);
+
+        // the first value takes the least significant bits of the first byte
+        auto bin = emit.Export();
+        CHECK(bin == vector<uint8_t>{0x2b, 0xaf, 0xbe, 0xfb, 0xb6, 0x7a, 0xff, 0x01});
+
+        eds::BitReader<const uint8_t*, eds::LsbFirst> reader(bin.data(), bin.data() + bin.size());
+        CHECK(reader.Peek(3) == 0x3);
+        CHECK(reader.Read(1) == 1);
+        CHECK(reader.Read(2) == 0x1);
+        CHECK(reader.Read(3) == 0x5);
+        CHECK(reader.Read(12) == 0xabc);
+        CHECK(reader.Read(32) == 0xdeadbeef);
+        CHECK(reader.Read(7) == 0x7f);
+        CHECK(reader.RemainingSize() == 7);
+
+        // random round trip with word and byte refills
         vector<int> v_len;
         vector<uint32_t> v_data;
-
         for (auto i = 0; i < kTestScale; ++i)
         {
             auto len = dis_len(gen);
             v_len.push_back(len);
-
-            uniform_int_distribution<> dis_byte{0, 1 << (len - 1)};
-            auto x = dis_byte(gen);
-            v_data.push_back(x);
+            v_data.push_back(uniform_int_distribution<uint32_t>{0, (1U << len) - 1}(gen));
         }
 
-        eds::BitEmitter emit;
+        eds::BasicBitEmitter<eds::LsbFirst> random_emit;
         for (auto i = 0; i < kTestScale; ++i)
         {
-            emit.Write(v_data[i], v_len[i]);
+            random_emit.Write(v_data[i], v_len[i]);
         }
-        auto bin = emit.Export();
+        auto random_bin = random_emit.Export();
 
-        eds::BitReader<uint8_t*> reader(bin.data(), bin.data() + bin.size());
-        vector<uint32_t> result;
+        eds::BitReader<const uint8_t*, eds::LsbFirst> ptr_reader(random_bin.data(), random_bin.data() + random_bin.size());
+        eds::BitReader<vector<uint8_t>::const_iterator, eds::LsbFirst> iter_reader(random_bin.cbegin(), random_bin.cend());
+        vector<uint32_t> ptr_result;
+        vector<uint32_t> iter_result;
         for (auto len : v_len)
         {
-            result.push_back(reader.Read(len));
+            ptr_result.push_back(ptr_reader.Read(len));
+            iter_result.push_back(iter_reader.Read(len));
         }
 
-        CHECK(result == v_data);
+        CHECK(ptr_result == v_data);
+        CHECK(iter_result == v_data);
     }
-}
\ No newline at end of file
+}
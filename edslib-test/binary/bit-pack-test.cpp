@@ -0,0 +1,82 @@
+#include "catch.hpp"
+#include "binary/bit-pack.h"
+#include <random>
+#include <vector>
+
+TEST_CASE("::bit-pack")
+{
+    using namespace std;
+
+    random_device rd;
+    default_random_engine gen{rd()};
+
+    // counts around the boundaries of 8-value blocks and of word loads at the end
+    const size_t counts[] = {0, 1, 7, 8, 9, 31, 1000, 1003};
+
+    SECTION("Round Trip")
+    {
+        for (int width = 1; width <= 32; ++width)
+        {
+            auto mask = ~uint32_t{0} >> (32 - width);
+            for (auto n : counts)
+            {
+                vector<uint32_t> v(n);
+                for (auto& x : v)
+                {
+                    x = static_cast<uint32_t>(gen()) & mask;
+                }
+
+                vector<uint8_t> packed(eds::PackedBitSize(n, width));
+                eds::PackBits(v.data(), n, width, packed.data());
+
+                // same layout as BitEmitter
+                eds::BitEmitter emit;
+                for (auto x : v)
+                {
+                    emit.Write(x, width);
+                }
+                CHECK(packed == emit.Export());
+
+                vector<uint32_t> unpacked(n);
+                eds::UnpackBits(packed.data(), n, width, unpacked.data());
+                CHECK(unpacked == v);
+            }
+        }
+    }
+
+    SECTION("High Bits Ignored")
+    {
+        vector<uint32_t> v = {0xffffffff, 0x12345678, 0x0};
+        vector<uint8_t> packed(eds::PackedBitSize(v.size(), 4));
+        eds::PackBits(v.data(), v.size(), 4, packed.data());
+
+        CHECK(packed == vector<uint8_t>{0xf8, 0x00});
+    }
+
+    SECTION("Scalar Kernels")
+    {
+        // the scalar path is taken by processors without AVX2 only, so test it on its own
+        for (int width = 1; width <= 32; ++width)
+        {
+            auto mask = ~uint32_t{0} >> (32 - width);
+
+            vector<uint32_t> v(1000);
+            for (auto& x : v)
+            {
+                x = static_cast<uint32_t>(gen()) & mask;
+            }
+
+            vector<uint8_t> packed(eds::PackedBitSize(v.size(), width));
+            eds::PackBits(v.data(), v.size(), width, packed.data());
+
+            auto loadable = eds::detail::CountWordLoadable(packed.size(), v.size(), width);
+            vector<uint32_t> unpacked(v.size());
+            eds::detail::DispatchBitWidth(width, [&](auto w) {
+                eds::detail::UnpackBitsScalar<decltype(w)::value>(packed.data(), 0, loadable, unpacked.data());
+            });
+            eds::detail::UnpackBitsTail(packed.data(), packed.size(), loadable, v.size(), width, unpacked.data());
+
+            CHECK(unpacked == v);
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include "catch.hpp"
+#include "compression/huffman.h"
+#include <random>
+#include <vector>
+
+TEST_CASE("::huffman")
+{
+    using namespace std;
+    using namespace eds::compression;
+
+    random_device rd;
+    default_random_engine gen{rd()};
+
+    // skewed bytes, where Huffman coding pays off
+    auto make_skewed = [&](size_t n) {
+        geometric_distribution<int> dis{0.1};
+
+        vector<uint8_t> v(n);
+        for (auto& x : v)
+        {
+            x = static_cast<uint8_t>(dis(gen));
+        }
+
+        return v;
+    };
+
+    SECTION("Code Lengths")
+    {
+        // frequencies of a complete binary tree
+        uint64_t freqs[] = {8, 4, 2, 1, 1, 0};
+        auto lengths     = BuildHuffmanLengths(freqs, 6);
+        CHECK(lengths == vector<uint8_t>{1, 2, 3, 4, 4, 0});
+
+        // fibonacci frequencies make the deepest tree, which must be cut down
+        vector<uint64_t> fib = {1, 1};
+        while (fib.size() < 40)
+        {
+            fib.push_back(fib[fib.size() - 1] + fib[fib.size() - 2]);
+        }
+
+        for (int max_length : {6, 12, kMaxHuffmanCodeLength})
+        {
+            lengths = BuildHuffmanLengths(fib.data(), fib.size(), max_length);
+
+            uint64_t kraft = 0;
+            for (auto len : lengths)
+            {
+                REQUIRE(len >= 1);
+                REQUIRE(len <= max_length);
+                kraft += uint64_t{1} << (max_length - len);
+            }
+            CHECK(kraft <= (uint64_t{1} << max_length));
+        }
+    }
+
+    SECTION("Round Trip")
+    {
+        for (size_t n : {0, 1, 2, 100, 100000})
+        {
+            auto v = make_skewed(n);
+
+            auto e = EncodeHuffman(v.begin(), v.end());
+            auto d = DecodeHuffman(e.begin(), e.end());
+            CHECK(d == v);
+        }
+
+        // a single symbol, and all symbols evenly
+        vector<uint8_t> v(1000, 'a');
+        auto e = EncodeHuffman(v.begin(), v.end());
+        CHECK(DecodeHuffman(e.begin(), e.end()) == v);
+
+        uniform_int_distribution<> dis{0, 255};
+        for (auto& x : v)
+        {
+            x = static_cast<uint8_t>(dis(gen));
+        }
+        e = EncodeHuffman(v.begin(), v.end());
+        CHECK(DecodeHuffman(e.data(), e.data() + e.size()) == v);
+    }
+
+    SECTION("Long Codes")
+    {
+        // codes longer than the lookup table of the decoder
+        vector<uint64_t> freqs(1000, 1);
+        freqs[0] = 1 << 20;
+        freqs[1] = 1 << 19;
+
+        HuffmanEncoder encoder{BuildHuffmanLengths(freqs.data(), freqs.size())};
+        HuffmanDecoder decoder{encoder.Lengths()};
+
+        vector<uint32_t> symbols;
+        uniform_int_distribution<uint32_t> dis{0, 999};
+        for (int i = 0; i < 10000; ++i)
+        {
+            symbols.push_back(i % 3 == 0 ? dis(gen) : i % 2);
+        }
+
+        eds::BitEmitter emit;
+        for (auto s : symbols)
+        {
+            encoder.Write(emit, s);
+        }
+
+        auto data = emit.Export();
+        eds::BitReader<const uint8_t*> reader{data.data(), data.data() + data.size()};
+        vector<uint32_t> decoded(symbols.size());
+        decoder.Read(reader, decoded.data(), decoded.size());
+        CHECK(decoded == symbols);
+
+        reader.Reset();
+        for (auto s : symbols)
+        {
+            REQUIRE(decoder.Read(reader) == s);
+        }
+    }
+
+    SECTION("Lzw Huffman")
+    {
+        auto v = make_skewed(200000);
+
+        auto e = EncodeLzwHuffman(v.begin(), v.end());
+        auto d = DecodeLzwHuffman(e.begin(), e.end());
+        CHECK(d == v);
+
+        // entropy coded codes take less space than packed ones
+        CHECK(e.size() < EncodeLzw(v.begin(), v.end()).size());
+
+        auto e2 = EncodeLzwHuffman<LzwResetOnFull>(v.begin(), v.end());
+        CHECK(DecodeLzwHuffman<LzwResetOnFull>(e2.begin(), e2.end()) == v);
+
+        // uniform codes are packed instead, at the cost of a few bytes of header
+        vector<uint8_t> u(200000);
+        uniform_int_distribution<> dis{0, 255};
+        for (auto& x : u)
+        {
+            x = static_cast<uint8_t>(dis(gen));
+        }
+
+        e = EncodeLzwHuffman(u.begin(), u.end());
+        CHECK(DecodeLzwHuffman(e.begin(), e.end()) == u);
+        CHECK(e.size() <= EncodeLzw(u.begin(), u.end()).size() + 9);
+
+        vector<uint8_t> truncated(e.begin(), e.end() - 100);
+        CHECK_THROWS(DecodeLzwHuffman(truncated.begin(), truncated.end()));
+
+        vector<uint8_t> empty;
+        e = EncodeLzwHuffman(empty.begin(), empty.end());
+        CHECK(DecodeLzwHuffman(e.begin(), e.end()).empty());
+    }
+
+    SECTION("Invalid Stream")
+    {
+        auto v = make_skewed(1000);
+        auto e = EncodeHuffman(v.begin(), v.end());
+
+        // truncated
+        vector<uint8_t> truncated(e.begin(), e.begin() + e.size() / 2);
+        CHECK_THROWS(DecodeHuffman(truncated.begin(), truncated.end()));
+        CHECK_THROWS(DecodeHuffman(e.begin(), e.begin() + 4));
+
+        // lengths over the Kraft limit
+        CHECK_THROWS(HuffmanDecoder{vector<uint8_t>{1, 1, 1}});
+    }
+}
@@ -0,0 +1,100 @@
+#include "catch.hpp"
+#include "compression/lzw-frame.h"
+#include <functional>
+#include <random>
+#include <vector>
+
+TEST_CASE("::compression::lzw-frame")
+{
+    using namespace std;
+    using namespace eds::compression;
+
+    random_device rd;
+    default_random_engine gen{rd()};
+    uniform_int_distribution<> dis_byte{0, 15};
+
+    // several chunks with a partial one at the end
+    vector<uint8_t> v(100000);
+    generate(v.begin(), v.end(), bind(dis_byte, gen));
+
+    LzwFrameOptions options;
+    options.chunk_size   = 8192;
+    options.thread_count = 4;
+
+    SECTION("Round Trip")
+    {
+        auto e = EncodeLzwFrame(v.data(), v.size(), options);
+        CHECK(e.size() < v.size());
+
+        // result does not depend on threads used
+        auto e_single = EncodeLzwFrame(v.data(), v.size(), LzwFrameOptions{options.chunk_size, 1});
+        CHECK(e == e_single);
+
+        CHECK(DecodeLzwFrame(e.data(), e.size(), 4) == v);
+        CHECK(DecodeLzwFrame(e.data(), e.size(), 1) == v);
+
+        auto e_reset = EncodeLzwFrame<LzwAdaptiveReset>(v.data(), v.size(), options);
+        CHECK(DecodeLzwFrame(e_reset.data(), e_reset.size()) == v);
+    }
+
+    SECTION("Empty Input")
+    {
+        auto e = EncodeLzwFrame(v.data(), 0, options);
+
+        LzwFrameReader reader{e.data(), e.size()};
+        CHECK(reader.Size() == 0);
+        CHECK(reader.ChunkCount() == 0);
+        CHECK(reader.ReadAll().empty());
+    }
+
+    SECTION("Random Access")
+    {
+        auto e = EncodeLzwFrame(v.data(), v.size(), options);
+
+        LzwFrameReader reader{e.data(), e.size()};
+        REQUIRE(reader.Size() == v.size());
+        CHECK(reader.ChunkSize() == options.chunk_size);
+        CHECK(reader.ChunkCount() == 13);
+
+        uniform_int_distribution<size_t> dis_offset{0, v.size()};
+        for (int i = 0; i < 20; ++i)
+        {
+            auto offset = dis_offset(gen);
+            auto size   = min(dis_offset(gen) / 4, v.size() - offset);
+
+            vector<uint8_t> d(size);
+            reader.Read(offset, size, d.data(), 2);
+            CHECK(equal(d.begin(), d.end(), v.begin() + offset));
+        }
+
+        // a range within one chunk
+        vector<uint8_t> d(10);
+        reader.Read(8190, 10, d.data());
+        CHECK(equal(d.begin(), d.end(), v.begin() + 8190));
+    }
+
+    SECTION("Invalid Frame")
+    {
+        auto e = EncodeLzwFrame(v.data(), v.size(), options);
+
+        // truncated header and index
+        CHECK_THROWS(LzwFrameReader{e.data(), 10});
+        CHECK_THROWS(LzwFrameReader{e.data(), 40});
+
+        // bad magic
+        auto bad_magic = e;
+        bad_magic[0] ^= 0xff;
+        CHECK_THROWS(LzwFrameReader{bad_magic.data(), bad_magic.size()});
+
+        // an offset out of order in the index
+        auto bad_index = e;
+        bad_index[24] = 0xff;
+        bad_index[25] = 0xff;
+        CHECK_THROWS(LzwFrameReader{bad_index.data(), bad_index.size()});
+
+        // a chunk decoding to the wrong size, the error is rethrown from workers
+        auto bad_size = e;
+        bad_size[16] ^= 0x01;
+        CHECK_THROWS(DecodeLzwFrame(bad_size.data(), bad_size.size(), 4));
+    }
+}
@@ -15,14 +15,187 @@ TEST_CASE("::compression")
     default_random_engine gen{rd()};
     uniform_int_distribution<> dis_len{0, 255};
 
-    for (int i = 0; i < kTestEpoch; ++i)
+    SECTION("Random Data")
     {
-        vector<uint8_t> v(kTestScale);
-        generate(v.begin(), v.end(), bind(dis_len, gen));
+        for (int i = 0; i < kTestEpoch; ++i)
+        {
+            vector<uint8_t> v(kTestScale);
+            generate(v.begin(), v.end(), bind(dis_len, gen));
+
+            auto e = EncodeLzw(v.begin(), v.end());
+            auto d = DecodeLzw(e.begin(), e.end());
+
+            CHECK(d == v);
+        }
+    }
+
+    SECTION("Empty Input")
+    {
+        vector<uint8_t> v;
+
+        auto e = EncodeLzw(v.begin(), v.end());
+        auto d = DecodeLzw(e.begin(), e.end());
+
+        CHECK(e.empty());
+        CHECK(d.empty());
+    }
+
+    SECTION("Dictionary Overflow")
+    {
+        // enough distinct sequences to exhaust all 16-bit codes, and more data afterwards
+        uniform_int_distribution<> dis_small{0, 15};
+
+        vector<uint8_t> v(1 << 20);
+        generate(v.begin(), v.end(), bind(dis_small, gen));
+        fill(v.begin() + (1 << 19), v.begin() + (1 << 19) + 5000, uint8_t{42});
 
         auto e = EncodeLzw(v.begin(), v.end());
         auto d = DecodeLzw(e.begin(), e.end());
 
+        CHECK(e.size() < v.size());
         CHECK(d == v);
     }
-}
\ No newline at end of file
+
+    SECTION("Invalid Stream")
+    {
+        // the second code refers far beyond the next code to be assigned
+        vector<uint8_t> v = {'a', 'b'};
+
+        auto e = EncodeLzw(v.begin(), v.end());
+        e[0]   = 0xff;
+        e[1]   = 0xff;
+
+        CHECK_THROWS(DecodeLzw(e.begin(), e.end()));
+    }
+
+    SECTION("Reset Policies")
+    {
+        // symbols drift to another alphabet after the dictionary is full
+        uniform_int_distribution<> dis_small{0, 15};
+
+        vector<uint8_t> v(1 << 21);
+        generate(v.begin(), v.end(), bind(dis_small, gen));
+        for (auto it = v.begin() + (1 << 20); it != v.end(); ++it)
+        {
+            *it += 128;
+        }
+
+        auto e_none     = EncodeLzw(v.begin(), v.end());
+        auto e_full     = EncodeLzw<LzwResetOnFull>(v.begin(), v.end());
+        auto e_adaptive = EncodeLzw<LzwAdaptiveReset>(v.begin(), v.end());
+
+        CHECK(DecodeLzw(e_none.begin(), e_none.end()) == v);
+        CHECK(DecodeLzw<LzwResetOnFull>(e_full.begin(), e_full.end()) == v);
+        CHECK(DecodeLzw<LzwAdaptiveReset>(e_adaptive.begin(), e_adaptive.end()) == v);
+
+        CHECK(e_full.size() < e_none.size());
+        CHECK(e_adaptive.size() < e_none.size());
+
+        // a short input never fills the dictionary
+        vector<uint8_t> w(kTestScale);
+        generate(w.begin(), w.end(), bind(dis_len, gen));
+
+        auto e = EncodeLzw<LzwAdaptiveReset>(w.begin(), w.end());
+        CHECK(DecodeLzw<LzwAdaptiveReset>(e.begin(), e.end()) == w);
+    }
+
+    SECTION("Streaming")
+    {
+        static constexpr size_t kChunkSize = 256;
+
+        uniform_int_distribution<> dis_small{0, 7};
+        uniform_int_distribution<> dis_piece{0, 3000};
+
+        vector<uint8_t> v(1 << 18);
+        generate(v.begin(), v.end(), bind(dis_small, gen));
+
+        vector<uint8_t> e;
+        vector<size_t> chunks;
+        auto encode_sink = [&](const uint8_t* data, size_t size) {
+            e.insert(e.end(), data, data + size);
+            chunks.push_back(size);
+        };
+
+        // feed in pieces of random sizes
+        LzwEncoder encoder{encode_sink, kChunkSize};
+        for (size_t offset = 0; offset < v.size();)
+        {
+            auto n = min<size_t>(dis_piece(gen), v.size() - offset);
+            encoder.Feed(v.data() + offset, n);
+            offset += n;
+        }
+        encoder.Finish();
+
+        // stream is the same as encoded at once and sent in fixed chunks
+        CHECK(e == EncodeLzw(v.begin(), v.end()));
+        CHECK(all_of(chunks.begin(), chunks.end() - 1, [](size_t n) { return n == kChunkSize; }));
+        CHECK(chunks.back() <= kChunkSize);
+
+        vector<uint8_t> d;
+        auto decode_sink = [&](const uint8_t* data, size_t size) {
+            CHECK(size <= kChunkSize);
+            d.insert(d.end(), data, data + size);
+        };
+
+        LzwDecoder decoder{decode_sink, kChunkSize};
+        for (size_t offset = 0; offset < e.size();)
+        {
+            auto n = min<size_t>(dis_piece(gen), e.size() - offset);
+            decoder.Feed(e.data() + offset, n);
+            offset += n;
+        }
+        decoder.Finish();
+
+        CHECK(d == v);
+    }
+
+    SECTION("Streaming Flush")
+    {
+        vector<uint8_t> v(kTestScale);
+        generate(v.begin(), v.end(), bind(dis_len, gen));
+
+        vector<uint8_t> e;
+        vector<uint8_t> d;
+        auto decode_sink = [&](const uint8_t* data, size_t size) { d.insert(d.end(), data, data + size); };
+        LzwDecoder<decltype(decode_sink), LzwResetOnFull> decoder{decode_sink};
+
+        // data fed before a flush is decodable from bytes sent so far, except for the last code
+        auto encode_sink = [&](const uint8_t* data, size_t size) {
+            e.insert(e.end(), data, data + size);
+            decoder.Feed(data, size);
+        };
+        LzwEncoder<decltype(encode_sink), LzwResetOnFull> encoder{encode_sink};
+
+        encoder.Feed(v.data(), v.size() / 2);
+        encoder.Flush();
+        decoder.Flush();
+        CHECK(d.size() > 0);
+        CHECK(d.size() <= v.size() / 2);
+        CHECK(equal(d.begin(), d.end(), v.begin()));
+
+        encoder.Feed(v.data() + v.size() / 2, v.size() - v.size() / 2);
+        encoder.Finish();
+        decoder.Finish();
+        CHECK(d == v);
+    }
+
+    SECTION("Bit Order")
+    {
+        // 'a' in 8 bits, then 'a' and 'b' in 9 bits
+        vector<uint8_t> v = {'a', 'a', 'b'};
+
+        auto e_msb = EncodeLzw(v.begin(), v.end());
+        auto e_lsb = EncodeLzw<LzwNoReset, eds::LsbFirst>(v.begin(), v.end());
+        CHECK(e_msb == vector<uint8_t>{0x61, 0x30, 0x98, 0x80});
+        CHECK(e_lsb == vector<uint8_t>{0x61, 0x61, 0xc4, 0x00});
+
+        CHECK(DecodeLzw<LzwNoReset, eds::LsbFirst>(e_lsb.begin(), e_lsb.end()) == v);
+
+        uniform_int_distribution<> dis_small{0, 15};
+        vector<uint8_t> w(1 << 20);
+        generate(w.begin(), w.end(), bind(dis_small, gen));
+
+        auto e = EncodeLzw<LzwResetOnFull, eds::LsbFirst>(w.begin(), w.end());
+        CHECK(DecodeLzw<LzwResetOnFull, eds::LsbFirst>(e.begin(), e.end()) == w);
+    }
+}
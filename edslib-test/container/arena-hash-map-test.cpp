@@ -0,0 +1,72 @@
+#include "catch.hpp"
+#include "container/arena-hash-map.h"
+#include <string>
+#include <vector>
+
+TEST_CASE("::ArenaHashMap")
+{
+    using namespace eds;
+
+    Arena arena;
+
+    SECTION("Insert And Lookup")
+    {
+        ArenaHashMap<int, std::string> map{arena};
+        for (int i = 0; i < 1000; ++i)
+        {
+            map[i * 16] = std::to_string(i);
+        }
+        CHECK(map.size() == 1000);
+        CHECK(map.bucket_count() >= 1000);
+
+        CHECK(map.count(16 * 42) == 1);
+        CHECK(map.find(16 * 42)->second == "42");
+        CHECK(map.find(17) == map.end());
+
+        auto [it, inserted] = map.try_emplace(16 * 42, "other");
+        CHECK_FALSE(inserted);
+        CHECK(it->second == "42");
+    }
+
+    SECTION("Insertion Order Iteration")
+    {
+        ArenaHashMap<std::string, int> map{arena};
+        map.insert({"c", 3});
+        map.insert({"a", 1});
+        map.insert({"b", 2});
+
+        std::vector<std::string> keys;
+        for (const auto& [key, value] : map)
+        {
+            keys.push_back(key);
+        }
+        CHECK(keys == std::vector<std::string>{"c", "a", "b"});
+    }
+
+    SECTION("Erase And Reuse")
+    {
+        ArenaHashMap<int, int> map{arena};
+        for (int i = 0; i < 100; ++i)
+        {
+            map[i] = i;
+        }
+
+        auto used = arena.GetByteUsed();
+        CHECK(map.erase(50) == 1);
+        CHECK(map.erase(50) == 0);
+        CHECK(map.find(50) == map.end());
+        CHECK(map.size() == 99);
+
+        map[1000] = 1000;
+        CHECK(arena.GetByteUsed() == used);
+        CHECK((--map.end())->first == 1000);
+
+        for (auto it = map.begin(); it != map.end();)
+        {
+            it = it->first % 2 == 0 ? map.erase(it) : std::next(it);
+        }
+        CHECK(map.size() == 50);
+        CHECK(map.count(1) == 1);
+        CHECK(map.count(2) == 0);
+    }
+}
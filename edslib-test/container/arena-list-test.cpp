@@ -0,0 +1,55 @@
+#include "catch.hpp"
+#include "container/arena-list.h"
+#include <string>
+#include <vector>
+
+TEST_CASE("::ArenaList")
+{
+    using namespace eds;
+
+    Arena arena;
+
+    SECTION("Insert And Erase")
+    {
+        ArenaList<std::string> list{arena};
+        list.push_back("b");
+        list.push_back("c");
+        list.push_front("a");
+        CHECK(list.size() == 3);
+        CHECK(list.front() == "a");
+        CHECK(list.back() == "c");
+
+        auto it = list.begin();
+        ++it;
+        it = list.erase(it);
+        CHECK(*it == "c");
+        list.insert(it, "B");
+
+        std::vector<std::string> values(list.begin(), list.end());
+        CHECK(values == std::vector<std::string>{"a", "B", "c"});
+
+        list.pop_front();
+        list.pop_back();
+        CHECK(list.size() == 1);
+        CHECK(list.front() == "B");
+    }
+
+    SECTION("Node Reuse")
+    {
+        ArenaList<int> list{arena};
+        for (int i = 0; i < 100; ++i)
+        {
+            list.push_back(i);
+        }
+
+        auto used = arena.GetByteUsed();
+        for (int round = 0; round < 10; ++round)
+        {
+            list.pop_front();
+            list.push_back(round);
+        }
+        CHECK(arena.GetByteUsed() == used);
+        CHECK(list.size() == 100);
+        CHECK(list.back() == 9);
+    }
+}
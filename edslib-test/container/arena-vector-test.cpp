@@ -0,0 +1,142 @@
+#include "catch.hpp"
+#include "container/arena-vector.h"
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+namespace
+{
+    // counts live objects, and throws on construction from a negative value
+    struct ThrowingElement
+    {
+        static inline int live_count = 0;
+
+        explicit ThrowingElement(int x)
+            : value(x)
+        {
+            if (x < 0)
+            {
+                throw x;
+            }
+
+            live_count += 1;
+        }
+        ~ThrowingElement()
+        {
+            live_count -= 1;
+        }
+
+        int value;
+    };
+}
+
+TEST_CASE("::ArenaVector")
+{
+    using namespace eds;
+
+    Arena arena;
+
+    SECTION("Push And Access")
+    {
+        ArenaVector<int> v{arena};
+        CHECK(v.empty());
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            v.push_back(i);
+        }
+        CHECK(v.size() == 1000);
+        CHECK(v.front() == 0);
+        CHECK(v.back() == 999);
+
+        bool all_match = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+            all_match &= v[i] == i;
+        }
+        CHECK(all_match);
+
+        // iteration crosses segment boundaries
+        CHECK(std::accumulate(v.begin(), v.end(), 0) == 999 * 1000 / 2);
+        CHECK(v.end() - v.begin() == 1000);
+        CHECK(*(v.begin() + 500) == 500);
+        CHECK(std::is_sorted(v.cbegin(), v.cend()));
+    }
+
+    SECTION("References Stay Valid")
+    {
+        ArenaVector<std::string> v{arena};
+
+        auto& first = v.emplace_back("a string long enough to be allocated on heap");
+        for (int i = 0; i < 500; ++i)
+        {
+            v.emplace_back(std::to_string(i));
+        }
+        CHECK(&first == &v[0]);
+        CHECK(first == "a string long enough to be allocated on heap");
+    }
+
+    SECTION("Pop And Reuse")
+    {
+        ArenaVector<std::string> v{arena};
+        for (int i = 0; i < 100; ++i)
+        {
+            v.emplace_back(std::to_string(i));
+        }
+
+        auto capacity = v.capacity();
+        while (v.size() > 10)
+        {
+            v.pop_back();
+            CHECK(v.back() == std::to_string(v.size() - 1));
+        }
+
+        for (int i = 10; i < 100; ++i)
+        {
+            v.emplace_back(std::to_string(i));
+        }
+        CHECK(v.capacity() == capacity);
+        CHECK(v[99] == "99");
+
+        auto used = arena.GetByteUsed();
+        v.clear();
+        CHECK(v.empty());
+        v.reserve(100);
+        v.emplace_back("x");
+        CHECK(arena.GetByteUsed() == used);
+    }
+
+    SECTION("Throwing Constructor")
+    {
+        using Vector = ArenaVector<ThrowingElement>;
+
+        {
+            Vector v{arena};
+            for (size_t i = 0; i < Vector::kFirstSegmentSize; ++i)
+            {
+                v.emplace_back(static_cast<int>(i));
+            }
+
+            // keep the next segment apart from the first one, so that reading past its start is caught
+            arena.Allocate(64);
+
+            // the next element starts a new segment
+            CHECK_THROWS(v.emplace_back(-1));
+            CHECK(v.size() == Vector::kFirstSegmentSize);
+            CHECK(v.back().value == static_cast<int>(Vector::kFirstSegmentSize) - 1);
+            CHECK(ThrowingElement::live_count == static_cast<int>(Vector::kFirstSegmentSize));
+
+            // the segment allocated is used by the next element
+            v.emplace_back(42);
+            CHECK(v.back().value == 42);
+            v.pop_back();
+            CHECK_THROWS(v.emplace_back(-1));
+            CHECK(v.back().value == static_cast<int>(Vector::kFirstSegmentSize) - 1);
+
+            Vector empty{arena};
+            CHECK_THROWS(empty.emplace_back(-1));
+            CHECK(empty.empty());
+        }
+        CHECK(ThrowingElement::live_count == 0);
+    }
+}
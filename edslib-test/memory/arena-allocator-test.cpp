@@ -0,0 +1,65 @@
+#include "catch.hpp"
+#include "memory/arena-allocator.h"
+#include "container/flat-set.h"
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+TEST_CASE("arena-allocator::")
+{
+    using namespace eds;
+
+    SECTION("Memory Resource")
+    {
+        Arena arena;
+        ArenaResource<> resource{arena};
+
+        std::pmr::vector<std::pmr::string> v{&resource};
+        for (int i = 0; i < 100; ++i)
+        {
+            v.emplace_back(std::to_string(i) + " is a long enough string to avoid sso");
+        }
+
+        CHECK(v.size() == 100);
+        CHECK(v[42] == "42 is a long enough string to avoid sso");
+        CHECK(arena.GetProvider().GetByteUsed() > 0);
+
+        // over-aligned requests
+        auto p = resource.allocate(100, 64);
+        CHECK(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+    }
+
+    SECTION("Allocator With FlatSet")
+    {
+        Arena arena;
+        ArenaAllocator<int> alloc{arena};
+
+        FlatSet<int, std::less<int>, ArenaAllocator<int>> s{alloc};
+        s.insert({5, 3, 1, 4, 2});
+        CHECK(s.size() == 5);
+        CHECK(std::is_sorted(s.begin(), s.end()));
+        CHECK(s.get_allocator() == alloc);
+
+        std::vector<std::string, ArenaAllocator<std::string>> v{ArenaAllocator<std::string>{arena}};
+        v.assign(10, "hello");
+        CHECK(v.back() == "hello");
+    }
+
+    SECTION("In-place Growth")
+    {
+        Arena arena;
+        ArenaAllocator<int> alloc{arena};
+
+        auto p = alloc.allocate(16);
+        CHECK(alloc.try_extend(p, 16, 64));
+        CHECK(arena.Allocate(16) == p + 64);
+
+        // only the most recent allocation could grow
+        CHECK_FALSE(alloc.try_extend(p, 64, 128));
+
+        // counts whose size in bytes overflows
+        CHECK_THROWS_AS(alloc.allocate(alloc.max_size() + 1), std::bad_array_new_length);
+        auto q = alloc.allocate(4);
+        CHECK_FALSE(alloc.try_extend(q, 4, alloc.max_size() + 1));
+    }
+}
@@ -0,0 +1,137 @@
+#include "catch.hpp"
+#include "memory/arena-handle.h"
+#include <string>
+#include <vector>
+
+// fails allocations once allocations_left drops to zero, -1 for never
+struct FailingMemoryProvider : eds::HeapGrowableMemoryProvider
+{
+    static inline int allocations_left = -1;
+
+    void* Allocate(size_t sz, size_t align = eds::kDefaultAlignment)
+    {
+        if (allocations_left == 0)
+        {
+            return nullptr;
+        }
+        if (allocations_left > 0)
+        {
+            allocations_left -= 1;
+        }
+
+        return eds::HeapGrowableMemoryProvider::Allocate(sz, align);
+    }
+};
+
+TEST_CASE("arena-handle::")
+{
+    using namespace eds;
+
+    SECTION("Stale Handles")
+    {
+        HandleArena<std::string> arena;
+
+        auto h1 = arena.Create("a string long enough to be allocated on heap");
+        auto h2 = arena.Create("another string");
+        CHECK(*arena.Get(h1) == "a string long enough to be allocated on heap");
+        CHECK(arena.Count() == 2);
+
+        arena.Destroy(h1);
+        CHECK_FALSE(arena.IsValid(h1));
+        CHECK(arena.Get(h1) == nullptr);
+
+        // the slot is reused with a new generation
+        auto h3 = arena.Create("reused");
+        CHECK(h3.index == h1.index);
+        CHECK(h3 != h1);
+        CHECK(arena.Get(h1) == nullptr);
+        CHECK(*arena.Get(h3) == "reused");
+
+        CHECK_FALSE(arena.IsValid(ArenaHandle<std::string>{}));
+        CHECK(*arena.Get(h2) == "another string");
+    }
+
+    SECTION("Compaction")
+    {
+        HandleArena<std::string> arena;
+
+        std::vector<ArenaHandle<std::string>> handles;
+        for (int i = 0; i < 10000; ++i)
+        {
+            handles.push_back(arena.Create(std::to_string(i)));
+        }
+
+        // keep one object in a hundred
+        for (int i = 0; i < 10000; ++i)
+        {
+            if (i % 100 != 0)
+            {
+                arena.Destroy(handles[i]);
+            }
+        }
+        auto allocated = arena.GetByteAllocated();
+        auto used      = arena.GetByteUsed();
+
+        arena.Compact();
+        CHECK(arena.GetByteAllocated() < allocated);
+        CHECK(arena.GetByteUsed() == 100 * sizeof(std::string));
+        CHECK(arena.GetByteUsed() < used);
+        CHECK(arena.Count() == 100);
+
+        bool all_match = true;
+        for (int i = 0; i < 10000; i += 100)
+        {
+            all_match &= arena.IsValid(handles[i]) && *arena.Get(handles[i]) == std::to_string(i);
+        }
+        CHECK(all_match);
+        CHECK_FALSE(arena.IsValid(handles[1]));
+    }
+
+    SECTION("Compaction Failure")
+    {
+        HandleArena<std::string, FailingMemoryProvider> arena;
+
+        std::vector<ArenaHandle<std::string>> handles;
+        for (int i = 0; i < 100; ++i)
+        {
+            handles.push_back(arena.Create("a string long enough to be allocated on heap " + std::to_string(i)));
+        }
+        for (int i = 0; i < 100; i += 2)
+        {
+            arena.Destroy(handles[i]);
+        }
+
+        auto all_match = [&] {
+            bool result = arena.Count() == 50;
+            for (int i = 1; i < 100; i += 2)
+            {
+                result &= arena.IsValid(handles[i]) &&
+                          *arena.Get(handles[i]) == "a string long enough to be allocated on heap " + std::to_string(i);
+            }
+
+            return result;
+        };
+
+        FailingMemoryProvider::allocations_left = 0;
+        CHECK_THROWS_AS(arena.Compact(), std::bad_alloc);
+        CHECK(all_match());
+
+        // a failure after some objects are moved must not leave them in the fresh arena
+        for (int n = 1; n < 4; ++n)
+        {
+            FailingMemoryProvider::allocations_left = n;
+            try
+            {
+                arena.Compact();
+            }
+            catch (const std::bad_alloc&)
+            {
+            }
+            CHECK(all_match());
+        }
+        FailingMemoryProvider::allocations_left = -1;
+
+        arena.Compact();
+        CHECK(*arena.Get(handles[99]) == "a string long enough to be allocated on heap 99");
+    }
+}
@@ -0,0 +1,81 @@
+#include "catch.hpp"
+#include "memory/arena-snapshot.h"
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    struct Node
+    {
+        int value;
+        eds::RelPtr<Node> next;
+    };
+
+    struct Root
+    {
+        int count;
+        eds::RelPtr<Node> head;
+    };
+}
+
+TEST_CASE("arena-snapshot::")
+{
+    using namespace eds;
+
+    std::string path = "arena-snapshot-test-" + std::to_string(reinterpret_cast<uintptr_t>(&path)) + ".bin";
+
+    SECTION("Save And Map")
+    {
+        {
+            BasicArena<MmapMemoryProvider<false>> arena{kMmapCommitSize};
+
+            auto root   = arena.Construct<Root>();
+            root->count = 100;
+            for (int i = 0; i < 100; ++i)
+            {
+                auto node   = arena.Construct<Node>();
+                node->value = i;
+                node->next  = root->head.Get();
+                root->head  = node;
+            }
+
+            CHECK(SaveSnapshot(arena, root, path.c_str()));
+        }
+
+        MappedSnapshot snapshot{path.c_str()};
+        REQUIRE(snapshot.IsOpen());
+
+        auto root = snapshot.Root<Root>();
+        CHECK(root->count == 100);
+
+        int expected = 99;
+        bool all_match = true;
+        for (auto node = root->head.Get(); node != nullptr; node = node->next.Get())
+        {
+            all_match &= node->value == expected--;
+        }
+        CHECK(all_match);
+        CHECK(expected == -1);
+    }
+
+    SECTION("Reject Invalid Files")
+    {
+        auto file = fopen(path.c_str(), "wb");
+        REQUIRE(file != nullptr);
+        SnapshotHeader header = {};
+        header.magic          = kSnapshotMagic;
+        header.version        = kSnapshotVersion;
+        header.pointer_size   = sizeof(void*);
+        // claims more data than present
+        header.data_size = 4096;
+        fwrite(&header, sizeof(header), 1, file);
+        fclose(file);
+
+        MappedSnapshot snapshot;
+        CHECK_FALSE(snapshot.Open(path.c_str()));
+        CHECK_FALSE(snapshot.Open("no-such-snapshot.bin"));
+        CHECK(snapshot.Root<Root>() == nullptr);
+    }
+
+    std::remove(path.c_str());
+}
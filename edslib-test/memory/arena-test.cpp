@@ -1,5 +1,7 @@
 #include "catch.hpp"
 #include "memory/arena.h"
+#include <string>
+#include <vector>
 
 namespace
 {
@@ -20,7 +22,8 @@ namespace
         int* p_;
     };
 
-    void DoAllocTest(eds::Arena& arena, int times)
+    template <typename TArena>
+    void DoAllocTest(TArena& arena, int times)
     {
         for (int i = 0; i < times; ++i)
         {
@@ -61,4 +64,214 @@ TEST_CASE("arena::")
         Arena arena;
         CHECK_NOTHROW(DoAllocTest(arena, 1000));
     }
+
+    SECTION("Checkpoint And Rewind")
+    {
+        int count = 0;
+
+        Arena arena;
+        arena.Construct<Inc>(&count);
+        auto outer = arena.GetCheckpoint();
+
+        arena.Construct<Inc>(&count);
+        DoAllocTest(arena, 100);
+        auto inner = arena.GetCheckpoint();
+
+        auto p1 = arena.Allocate(64);
+        arena.Construct<Inc>(&count);
+        CHECK(count == 3);
+
+        arena.RewindTo(inner);
+        CHECK(count == 2);
+        CHECK(arena.Allocate(64) == p1);
+
+        arena.RewindTo(outer);
+        CHECK(count == 1);
+        CHECK_NOTHROW(DoAllocTest(arena, 100));
+
+        // checkpoint of an empty arena
+        Arena empty_arena;
+        auto initial = empty_arena.GetCheckpoint();
+        DoAllocTest(empty_arena, 100);
+        empty_arena.RewindTo(initial);
+        CHECK_NOTHROW(DoAllocTest(empty_arena, 100));
+    }
+
+    SECTION("Array Construction")
+    {
+        int count = 0;
+
+        {
+            Arena arena;
+            auto arr = arena.ConstructArray<Inc>(100, &count);
+            CHECK(arr != nullptr);
+            CHECK(count == 100);
+
+            auto nums = arena.ConstructArray<int>(10, 7);
+            CHECK(std::all_of(nums, nums + 10, [](int x) { return x == 7; }));
+
+            std::vector<std::string> src = {"a", "bb", "ccc"};
+            auto strs = arena.ConstructRange<std::string>(src.begin(), src.end());
+            CHECK(std::equal(src.begin(), src.end(), strs));
+
+            // lengths whose size in bytes overflows
+            CHECK_THROWS_AS(arena.ConstructArray<int>(SIZE_MAX / 2, 7), std::bad_alloc);
+            CHECK_THROWS_AS(arena.ConstructArray<Inc>(SIZE_MAX / sizeof(Inc), &count), std::bad_alloc);
+            CHECK(count == 100);
+        }
+        CHECK(count == 0);
+    }
+
+    SECTION("Statistics")
+    {
+        eds::BasicArena<eds::BasicHeapGrowableMemoryProvider<eds::ArenaStats>> arena;
+
+        auto checkpoint = arena.GetCheckpoint();
+        arena.Allocate(16);
+        arena.Allocate(100);
+        arena.Allocate(5000);
+        CHECK(arena.GetByteUsed() == 16 + 100 + 5000);
+
+        arena.RewindTo(checkpoint);
+        CHECK(arena.GetByteUsed() == 0);
+        CHECK(arena.GetByteAllocated() == 4096 - 32);
+
+        const auto& stats = arena.GetProvider().GetStats();
+        CHECK(stats.allocation_count == 3);
+        CHECK(stats.allocation_histogram[4] == 1);
+        CHECK(stats.allocation_histogram[7] == 1);
+        CHECK(stats.allocation_histogram[13] == 1);
+        CHECK(stats.big_chunk_count == 1);
+        CHECK(stats.peak_byte_used == 16 + 100 + 5000);
+
+        DoAllocTest(arena, 1000);
+        CHECK(stats.abandoned_block_count > 0);
+        CHECK(stats.fragmented_bytes > 0);
+    }
+
+    SECTION("Growth Policies")
+    {
+        using eds::BasicArena;
+        using eds::BasicHeapGrowableMemoryProvider;
+        using eds::NullArenaStats;
+
+        BasicArena<BasicHeapGrowableMemoryProvider<NullArenaStats, eds::FixedGrowth<8192>>> fixed;
+        for (int i = 0; i < 1000; ++i)
+        {
+            fixed.Allocate(i % 2000);
+        }
+        CHECK(fixed.GetByteAllocated() % (8192 - 32) == 0);
+
+        BasicArena<BasicHeapGrowableMemoryProvider<NullArenaStats, eds::RuntimeGrowth>> runtime;
+        runtime.GetProvider().GetGrowthPolicy().SetInitialBlockSize(16384);
+        runtime.Allocate(16);
+        CHECK(runtime.GetByteAllocated() == 16384 - 32);
+        CHECK_NOTHROW(DoAllocTest(runtime, 100));
+
+        // adaptive growth sizes the first block after the last cycle
+        BasicArena<BasicHeapGrowableMemoryProvider<NullArenaStats, eds::AdaptiveGrowth<>>> adaptive;
+        for (int i = 0; i < 100; ++i)
+        {
+            adaptive.Allocate(1000);
+        }
+        CHECK(adaptive.GetByteAllocated() > 100 * 1000);
+
+        adaptive.Clear();
+        adaptive.Allocate(1000);
+        CHECK(adaptive.GetByteAllocated() >= 100 * 1000);
+        for (int i = 1; i < 100; ++i)
+        {
+            adaptive.Allocate(1000);
+        }
+        CHECK(adaptive.GetByteAllocated() == 131072 - 32);
+    }
+
+    SECTION("Aligned Allocation")
+    {
+        struct alignas(64) Lane
+        {
+            float values[16];
+        };
+        struct alignas(32) Tracked
+        {
+            std::string name;
+        };
+
+        auto is_aligned = [](const void* p, size_t align) { return reinterpret_cast<uintptr_t>(p) % align == 0; };
+
+        Arena arena;
+
+        // small objects are packed at their natural alignment
+        auto c1 = arena.Construct<char>('a');
+        auto c2 = arena.Construct<char>('b');
+        auto i1 = arena.Construct<int>(42);
+        CHECK(c2 == c1 + 1);
+        CHECK(is_aligned(i1, alignof(int)));
+        CHECK(reinterpret_cast<char*>(i1) - c1 == alignof(int));
+
+        auto lane = arena.Construct<Lane>();
+        CHECK(is_aligned(lane, 64));
+
+        auto tracked = arena.Construct<Tracked>(Tracked{"a string long enough to be allocated on heap"});
+        CHECK(is_aligned(tracked, 32));
+        CHECK(tracked->name == "a string long enough to be allocated on heap");
+
+        auto lanes = arena.ConstructArray<Tracked>(3);
+        CHECK(is_aligned(lanes, 32));
+
+        for (size_t align : {8, 64, 256, 4096})
+        {
+            CHECK(is_aligned(arena.AllocateAligned(100, align), align));
+            CHECK(is_aligned(arena.AllocateAligned(3000, align), align));
+        }
+
+        // untyped allocations keep the default alignment
+        arena.Allocate(1);
+        CHECK(is_aligned(arena.Allocate(1), alignof(std::max_align_t)));
+
+        eds::Workspace ws;
+        ws.Allocate(1);
+        CHECK(is_aligned(ws.AllocateAligned(64, 64), 64));
+    }
+
+    SECTION("Workspace Rewind")
+    {
+        eds::Workspace ws;
+        auto checkpoint = ws.GetCheckpoint();
+
+        auto p1 = ws.Allocate(100);
+        ws.Allocate(200);
+        ws.RewindTo(checkpoint);
+        CHECK(ws.Allocate(100) == p1);
+    }
+
+    SECTION("Spillable Workspace")
+    {
+        eds::SpillableWorkspace ws;
+        auto checkpoint = ws.GetCheckpoint();
+
+        // fits in the inline buffer
+        auto p1 = ws.Allocate(1024);
+        CHECK(ws.GetProvider().GetSpillStats().spill_count == 0);
+
+        // spills instead of failing once the buffer is exhausted
+        auto p2 = ws.Construct<std::string>("a string long enough to be allocated on heap");
+        CHECK(ws.Allocate(4000) != nullptr);
+        CHECK(ws.Allocate(100000) != nullptr);
+        CHECK(*p2 == "a string long enough to be allocated on heap");
+        CHECK(ws.GetProvider().GetSpillStats().spill_count == 2);
+        CHECK(ws.GetByteUsed() >= 1024 + 4000 + 100000);
+
+        ws.RewindTo(checkpoint);
+        CHECK(ws.Allocate(1024) == p1);
+
+        ws.Clear();
+        ws.Allocate(100);
+        ws.Clear();
+
+        auto& stats = ws.GetProvider().GetSpillStats();
+        CHECK(stats.cycle_count == 2);
+        CHECK(stats.spilled_cycle_count == 1);
+        CHECK(ws.GetByteUsed() == 0);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "catch.hpp"
+#include "memory/block-recycler.h"
+#include "memory/arena.h"
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("block-recycler::")
+{
+    using eds::BlockRecycler;
+
+    SECTION("Reuse Freed Blocks")
+    {
+        auto p1 = BlockRecycler::Allocate(4096);
+        BlockRecycler::Deallocate(p1, 4096);
+
+        auto p2 = BlockRecycler::Allocate(4096);
+        CHECK(p1 == p2);
+
+        // blocks of other size classes are not mixed up
+        auto p3 = BlockRecycler::Allocate(8192);
+        CHECK(p3 != p2);
+
+        BlockRecycler::Deallocate(p2, 4096);
+        BlockRecycler::Deallocate(p3, 8192);
+    }
+
+    SECTION("Unrecyclable Sizes")
+    {
+        CHECK(BlockRecycler::IsRecyclable(4096));
+        CHECK(BlockRecycler::IsRecyclable(65536));
+        CHECK_FALSE(BlockRecycler::IsRecyclable(5000));
+        CHECK_FALSE(BlockRecycler::IsRecyclable(131072));
+
+        auto p = BlockRecycler::Allocate(5000);
+        CHECK(p != nullptr);
+        BlockRecycler::Deallocate(p, 5000);
+    }
+
+    SECTION("Arena Recycles Blocks")
+    {
+        void* p1 = nullptr;
+        {
+            eds::Arena arena;
+            p1 = arena.Allocate(100);
+        }
+
+        eds::Arena arena;
+        auto p2 = arena.Allocate(100);
+        CHECK(p1 == p2);
+    }
+
+    SECTION("Cross Thread Recycling")
+    {
+        BlockRecycler::Trim();
+        BlockRecycler::SetThreadCacheLimit(4);
+
+        std::mutex mutex;
+        std::set<void*> freed;
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([&] {
+                std::vector<void*> blocks;
+                for (int k = 0; k < 100; ++k)
+                {
+                    for (int j = 0; j < 16; ++j)
+                    {
+                        blocks.push_back(BlockRecycler::Allocate(16384));
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        freed.insert(blocks.begin(), blocks.end());
+                    }
+                    for (auto p : blocks)
+                    {
+                        BlockRecycler::Deallocate(p, 16384);
+                    }
+                    blocks.clear();
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+
+        // blocks left by the workers are handed over to the main thread through the global pool
+        auto p = BlockRecycler::Allocate(16384);
+        CHECK(freed.count(p) == 1);
+        BlockRecycler::Deallocate(p, 16384);
+
+        BlockRecycler::SetThreadCacheLimit(BlockRecycler::kDefaultThreadCacheLimit);
+        BlockRecycler::Trim();
+    }
+
+    SECTION("Trim While Recycling")
+    {
+        BlockRecycler::Trim();
+        BlockRecycler::SetThreadCacheLimit(2);
+
+        std::atomic<bool> done{false};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([&] {
+                std::vector<void*> blocks;
+                while (!done)
+                {
+                    for (int j = 0; j < 8; ++j)
+                    {
+                        blocks.push_back(BlockRecycler::Allocate(32768));
+                    }
+                    for (auto p : blocks)
+                    {
+                        BlockRecycler::Deallocate(p, 32768);
+                    }
+                    blocks.clear();
+                }
+            });
+        }
+        for (int i = 0; i < 2000; ++i)
+        {
+            BlockRecycler::Trim();
+            std::this_thread::yield();
+        }
+        done = true;
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        BlockRecycler::Trim();
+
+        // the global pool must still take blocks, i.e. its count isn't corrupted by Trim
+        std::set<void*> freed;
+        std::thread worker{[&] {
+            for (int j = 0; j < 8; ++j)
+            {
+                freed.insert(BlockRecycler::Allocate(32768));
+            }
+            for (auto p : freed)
+            {
+                BlockRecycler::Deallocate(p, 32768);
+            }
+        }};
+        worker.join();
+
+        std::set<void*> reused;
+        for (int j = 0; j < 8; ++j)
+        {
+            reused.insert(BlockRecycler::Allocate(32768));
+        }
+        CHECK(reused == freed);
+        for (auto p : reused)
+        {
+            BlockRecycler::Deallocate(p, 32768);
+        }
+
+        BlockRecycler::SetThreadCacheLimit(BlockRecycler::kDefaultThreadCacheLimit);
+        BlockRecycler::Trim();
+    }
+
+    SECTION("After Thread Cache Destroyed")
+    {
+        struct Observation
+        {
+            void* late_block    = nullptr;
+            size_t count_before = 0;
+            size_t count_after  = 0;
+        };
+
+        // thread-local objects constructed before the thread cache are destroyed after it, as
+        // static arenas are after the cache of the main thread
+        struct LateUser
+        {
+            Observation* observation;
+
+            ~LateUser()
+            {
+                observation->count_before = BlockRecycler::GetGlobalCount(4096);
+
+                eds::Arena arena;
+                observation->late_block = arena.Allocate(100);
+
+                observation->count_after = BlockRecycler::GetGlobalCount(4096);
+            }
+        };
+
+        Observation observation;
+        std::thread worker{[&] {
+            thread_local LateUser user{&observation};
+
+            // the thread cache is created here and flushed into the global pool on exit
+            BlockRecycler::Deallocate(BlockRecycler::Allocate(4096), 4096);
+        }};
+        worker.join();
+
+        // the arena takes its block from the global allocator and leaves the global pool untouched
+        CHECK(observation.late_block != nullptr);
+        CHECK(observation.count_before > 0);
+        CHECK(observation.count_after == observation.count_before);
+    }
+}
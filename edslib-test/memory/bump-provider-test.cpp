@@ -0,0 +1,169 @@
+#include "catch.hpp"
+#include "memory/bump-provider.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // keeps allocation results observable so the benchmark loop is not optimized away
+    volatile uintptr_t g_sink;
+
+    // best of several runs to filter out warm-up and scheduling noise
+    // allocated memory is not touched so that the allocator itself is measured rather than cache misses
+    template <typename TArena>
+    double RunMixedWorkload(const std::vector<size_t>& sizes, int rounds)
+    {
+        using namespace std::chrono;
+
+        auto best = std::numeric_limits<double>::max();
+        uintptr_t checksum = 0;
+        for (int run = 0; run < 5; ++run)
+        {
+            TArena arena;
+            auto start = high_resolution_clock::now();
+            for (int i = 0; i < rounds; ++i)
+            {
+                for (auto sz : sizes)
+                {
+                    checksum ^= reinterpret_cast<uintptr_t>(arena.Allocate(sz));
+                }
+
+                arena.Clear();
+            }
+
+            best = std::min(best, duration<double, std::milli>(high_resolution_clock::now() - start).count());
+        }
+
+        g_sink = checksum;
+
+        return best;
+    }
+
+    std::vector<size_t> GenerateSizes(int count, int large_percent)
+    {
+        std::default_random_engine gen{42};
+        std::uniform_int_distribution<size_t> dis_small{8, 128};
+        std::uniform_int_distribution<size_t> dis_large{129, 2048};
+        std::uniform_int_distribution<int> dis_kind{0, 99};
+
+        std::vector<size_t> sizes;
+        for (int i = 0; i < count; ++i)
+        {
+            sizes.push_back(eds::RoundToAlign(dis_kind(gen) < large_percent ? dis_large(gen) : dis_small(gen), 16));
+        }
+
+        return sizes;
+    }
+}
+
+TEST_CASE("bump-provider::")
+{
+    using namespace eds;
+
+    SECTION("Bump Allocation")
+    {
+        BumpArena arena;
+
+        auto p1 = reinterpret_cast<uint8_t*>(arena.Allocate(16));
+        auto p2 = reinterpret_cast<uint8_t*>(arena.Allocate(32));
+        CHECK(p2 == p1 + 16);
+        CHECK(arena.GetByteUsed() == 48);
+
+        arena.Allocate(3000);
+        CHECK(arena.GetByteUsed() == 48 + 3000);
+
+        // the current block is retired once it cannot serve a request
+        for (int i = 0; i < 10; ++i)
+        {
+            arena.Allocate(2000);
+        }
+        CHECK(arena.GetByteUsed() == 48 + 3000 + 20000);
+    }
+
+    SECTION("Zero Size")
+    {
+        // never null, so that it can't be mistaken for running out of memory
+        BumpMemoryProvider<> provider;
+        CHECK(provider.Allocate(0) != nullptr);
+
+        BumpMemoryProvider<FixedGrowth<4096>, 4> tail_provider;
+        CHECK(tail_provider.Allocate(0) != nullptr);
+
+        BumpArena arena;
+        CHECK(arena.Allocate(0) != nullptr);
+        CHECK(arena.Allocate(16) != nullptr);
+    }
+
+    SECTION("Tail Reuse")
+    {
+        BasicArena<BumpMemoryProvider<FixedGrowth<4096>, 4>> arena;
+
+        // each block has 4080 bytes
+        arena.Allocate(2032);
+        arena.Allocate(2032);
+        // the first block is retired without a tail
+        arena.Allocate(1000);
+        auto p1 = reinterpret_cast<uint8_t*>(arena.Allocate(2048));
+        // the second block is retired with 1032 bytes left
+        arena.Allocate(2000);
+        arena.Allocate(2000);
+
+        // the tail of the second block becomes the current region instead of starting a new block
+        auto p2 = reinterpret_cast<uint8_t*>(arena.Allocate(512));
+        CHECK(p2 == p1 + 2048);
+        auto p3 = reinterpret_cast<uint8_t*>(arena.Allocate(80));
+        CHECK(p3 == p1 + 2048 + 512);
+        CHECK(arena.GetByteAllocated() == 3 * 4080);
+    }
+
+    SECTION("Checkpoint And Rewind")
+    {
+        BumpArena arena;
+
+        arena.Allocate(100);
+        auto checkpoint = arena.GetCheckpoint();
+        auto used       = arena.GetByteUsed();
+        auto p1         = arena.Allocate(100);
+        for (int i = 0; i < 100; ++i)
+        {
+            arena.Allocate(1000);
+        }
+        auto allocated = arena.GetByteAllocated();
+
+        arena.RewindTo(checkpoint);
+        CHECK(arena.GetByteUsed() == used);
+        CHECK(arena.Allocate(100) == p1);
+
+        // spare blocks are reused instead of allocating new ones
+        for (int i = 0; i < 100; ++i)
+        {
+            arena.Allocate(1000);
+        }
+        CHECK(arena.GetByteAllocated() == allocated);
+    }
+}
+
+TEST_CASE("bump-provider::benchmark", "[.][benchmark]")
+{
+    using namespace eds;
+
+    static constexpr auto kAllocCount = 10000;
+    static constexpr auto kRoundCount = 500;
+
+    for (auto large_percent : {0, 10, 30, 60})
+    {
+        auto sizes  = GenerateSizes(kAllocCount, large_percent);
+        auto t_heap = RunMixedWorkload<Arena>(sizes, kRoundCount);
+        auto t_bump = RunMixedWorkload<BumpArena>(sizes, kRoundCount);
+        auto t_tail = RunMixedWorkload<BasicArena<BumpMemoryProvider<GeometricGrowth<>, 8>>>(sizes, kRoundCount);
+
+        printf("mixed-size allocation, %d x %d requests, %d%% in (128, 2048]\n", kRoundCount, kAllocCount, large_percent);
+        printf("  HeapGrowableMemoryProvider:       %8.2f ms\n", t_heap);
+        printf("  BumpMemoryProvider:               %8.2f ms\n", t_bump);
+        printf("  BumpMemoryProvider (tail index):  %8.2f ms\n", t_tail);
+    }
+}
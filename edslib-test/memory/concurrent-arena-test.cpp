@@ -0,0 +1,96 @@
+#include "catch.hpp"
+#include "memory/concurrent-arena.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    class AtomicInc
+    {
+    public:
+        AtomicInc(std::atomic<int>* p, int value) : p_(p), value_(value)
+        {
+            *p_ += 1;
+        }
+
+        ~AtomicInc()
+        {
+            *p_ -= 1;
+        }
+
+        int Value() const { return value_; }
+
+    private:
+        std::atomic<int>* p_;
+        int value_;
+    };
+}
+
+TEST_CASE("concurrent-arena::")
+{
+    using eds::ConcurrentArena;
+
+    static constexpr auto kThreadCount = 8;
+    static constexpr auto kAllocCount  = 2000;
+
+    SECTION("Parallel Construction")
+    {
+        std::atomic<int> count{0};
+        std::vector<std::vector<AtomicInc*>> results(kThreadCount);
+
+        {
+            ConcurrentArena arena;
+
+            std::vector<std::thread> threads;
+            for (int i = 0; i < kThreadCount; ++i)
+            {
+                threads.emplace_back([&, i] {
+                    for (int k = 0; k < kAllocCount; ++k)
+                    {
+                        results[i].push_back(arena.Construct<AtomicInc>(&count, i * kAllocCount + k));
+
+                        // mix in some larger and big allocations
+                        arena.Allocate(k % 7 == 0 ? 3000 : k % 600);
+                    }
+                });
+            }
+            for (auto& t : threads)
+            {
+                t.join();
+            }
+
+            CHECK(count == kThreadCount * kAllocCount);
+
+            // no allocation overlaps with another
+            std::vector<int> values;
+            for (auto& v : results)
+            {
+                for (auto p : v)
+                {
+                    values.push_back(p->Value());
+                }
+            }
+            std::sort(values.begin(), values.end());
+            CHECK(values.size() == kThreadCount * kAllocCount);
+            CHECK(std::adjacent_find(values.begin(), values.end()) == values.end());
+            CHECK(values.back() == kThreadCount * kAllocCount - 1);
+        }
+        CHECK(count == 0);
+    }
+
+    SECTION("Clear And Reuse")
+    {
+        ConcurrentArena arena;
+        for (int i = 0; i < 3; ++i)
+        {
+            auto p = arena.Construct<int>(i);
+            CHECK(*p == i);
+            CHECK(arena.GetProvider().GetByteUsed() > 0);
+
+            arena.Clear();
+            CHECK(arena.GetProvider().GetByteUsed() == 0);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#include "catch.hpp"
+#include "memory/mmap-provider.h"
+#include <algorithm>
+#include <cstring>
+
+TEST_CASE("mmap-provider::")
+{
+    using namespace eds;
+
+    SECTION("Contiguous Allocation")
+    {
+        MmapArena arena;
+
+        auto p1 = reinterpret_cast<uint8_t*>(arena.Allocate(16));
+        auto p2 = reinterpret_cast<uint8_t*>(arena.Allocate(16));
+        CHECK(p2 == p1 + 16);
+
+        // allocations beyond the commit granularity are still contiguous
+        auto big = reinterpret_cast<uint8_t*>(arena.Allocate(5 * kMmapCommitSize));
+        CHECK(big == p2 + 16);
+        std::memset(big, 0xCC, 5 * kMmapCommitSize);
+        CHECK(arena.GetProvider().GetByteAllocated() >= 5 * kMmapCommitSize);
+    }
+
+    SECTION("Clear Releases Pages")
+    {
+        MmapArena arena;
+
+        auto p1 = reinterpret_cast<uint8_t*>(arena.Allocate(4096));
+        std::memset(p1, 0xCC, 4096);
+        arena.Clear();
+        CHECK(arena.GetByteAllocated() == 0);
+
+        auto p2 = reinterpret_cast<uint8_t*>(arena.Allocate(4096));
+        CHECK(p1 == p2);
+        CHECK(std::all_of(p2, p2 + 4096, [](uint8_t x) { return x == 0; }));
+        CHECK(arena.GetByteAllocated() == kMmapCommitSize);
+    }
+
+    SECTION("Reservation Limit")
+    {
+        BasicArena<MmapMemoryProvider<false, true>> arena{kMmapCommitSize};
+
+        auto checkpoint = arena.GetCheckpoint();
+        CHECK(arena.Allocate(kMmapCommitSize / 2) != nullptr);
+        CHECK(arena.Allocate(kMmapCommitSize) == nullptr);
+
+        arena.RewindTo(checkpoint);
+        CHECK(arena.Allocate(kMmapCommitSize) != nullptr);
+    }
+}
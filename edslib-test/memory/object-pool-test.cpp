@@ -0,0 +1,74 @@
+#include "catch.hpp"
+#include "memory/object-pool.h"
+#include <string>
+#include <vector>
+
+TEST_CASE("object-pool::")
+{
+    using namespace eds;
+
+    SECTION("Slot Reuse")
+    {
+        ObjectPool<std::string> pool;
+
+        auto s1 = pool.Construct("a string long enough to be allocated on heap");
+        auto s2 = pool.Construct("another string");
+        CHECK(pool.Count() == 2);
+
+        pool.Destroy(s1);
+        CHECK(pool.Count() == 1);
+
+        // freed slot is reused first
+        auto s3 = pool.Construct("reused");
+        CHECK(s3 == s1);
+        CHECK(*s3 == "reused");
+
+        pool.Destroy(s2);
+        pool.Destroy(s3);
+        CHECK(pool.Count() == 0);
+    }
+
+    SECTION("Bounded Memory With Churn")
+    {
+        ObjectPool<std::pair<int, int>> pool;
+
+        std::vector<std::pair<int, int>*> live;
+        for (int i = 0; i < 100; ++i)
+        {
+            live.push_back(pool.Construct(i, i));
+        }
+
+        auto allocated = pool.GetProvider().GetByteUsed();
+        for (int round = 0; round < 1000; ++round)
+        {
+            auto index = round % live.size();
+            pool.Destroy(live[index]);
+            live[index] = pool.Construct(round, round);
+        }
+        CHECK(pool.GetProvider().GetByteUsed() == allocated);
+
+        for (auto p : live)
+        {
+            pool.Destroy(p);
+        }
+    }
+
+    SECTION("Size Classes")
+    {
+        PoolAllocator<> alloc;
+
+        auto p1 = alloc.Allocate(24);
+        auto p2 = alloc.Allocate(100);
+        alloc.Deallocate(p1, 24);
+        alloc.Deallocate(p2, 100);
+
+        // slots are shared within a size class only
+        CHECK(alloc.Allocate(32) == p1);
+        CHECK(alloc.Allocate(24) != p1);
+        CHECK(alloc.Allocate(112) == p2);
+
+        auto big = alloc.Allocate(4096);
+        CHECK(big != nullptr);
+        alloc.Deallocate(big, 4096);
+    }
+}
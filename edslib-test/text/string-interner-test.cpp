@@ -0,0 +1,69 @@
+#include "catch.hpp"
+#include "text/string-interner.h"
+#include "text/text-utils.h"
+#include <string>
+#include <vector>
+
+TEST_CASE("string-interner::")
+{
+    using namespace eds::text;
+
+    eds::Arena arena;
+    StringInterner interner{arena};
+
+    SECTION("Unique Ids")
+    {
+        auto a = interner.Intern("alpha");
+        auto b = interner.Intern("beta");
+        CHECK(a == 0);
+        CHECK(b == 1);
+        CHECK(interner.Intern(std::string("alpha")) == a);
+        CHECK(interner.Size() == 2);
+
+        CHECK(interner.Find("beta") == b);
+        CHECK(interner.Find("gamma") == StringInterner::kInvalidId);
+        CHECK(interner.Lookup(a) == "alpha");
+
+        // views are stable and null-terminated
+        auto view = interner.InternView("alpha");
+        CHECK(view.data() == interner.Lookup(a).data());
+        CHECK(view.data()[view.size()] == '\0');
+    }
+
+    SECTION("Growth Keeps Ids")
+    {
+        std::vector<StringInterner::Id> ids;
+        for (int i = 0; i < 10000; ++i)
+        {
+            ids.push_back(interner.Intern("identifier_" + std::to_string(i)));
+        }
+        CHECK(interner.Size() == 10000);
+
+        bool all_match = true;
+        for (int i = 0; i < 10000; ++i)
+        {
+            auto s = "identifier_" + std::to_string(i);
+            all_match &= interner.Intern(s) == ids[i] && interner.Lookup(ids[i]) == s;
+        }
+        CHECK(all_match);
+        CHECK(interner.Size() == 10000);
+    }
+
+    SECTION("Lexer Tokens")
+    {
+        zstring source = "let x = x + y";
+
+        std::vector<StringInterner::Id> tokens;
+        while (*source)
+        {
+            auto token = ConsumeWhile(source, [](char ch) { return ch != ' '; });
+            tokens.push_back(interner.Intern(token));
+            ConsumeIf(source, ' ');
+        }
+
+        CHECK(tokens.size() == 6);
+        CHECK(tokens[1] == tokens[3]);
+        CHECK(interner.Size() == 5);
+        CHECK(interner.Lookup(tokens[4]) == "+");
+    }
+}
@@ -16,4 +16,19 @@ TEST_CASE("::text")
 		CHECK_FALSE(ConsumeIfRange(x, 'a', 'z'));
 		CHECK(ConsumeIfAny(x, "\t\r\n "));
 	}
+
+	SECTION("ConsumeWhile")
+	{
+		zstring x = "hello42 world";
+
+		auto is_alpha = [](char ch) { return ch >= 'a' && ch <= 'z'; };
+		auto is_digit = [](char ch) { return ch >= '0' && ch <= '9'; };
+
+		CHECK(ConsumeWhile(x, is_alpha) == "hello");
+		CHECK(ConsumeWhile(x, is_alpha).empty());
+		CHECK(ConsumeWhile(x, is_digit) == "42");
+		CHECK(ConsumeIf(x, ' '));
+		CHECK(ConsumeWhile(x, is_alpha) == "world");
+		CHECK(*x == '\0');
+	}
 }
\ No newline at end of file
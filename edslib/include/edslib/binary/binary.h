@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <type_traits>
 #include <complex>
 
@@ -8,6 +11,20 @@ namespace eds::binary
 {
     using MemoryBuffer = std::vector<uint8_t>;
 
+    // max bytes of a 64-bit varint, 7 bits in each byte
+    static constexpr int kMaxVarintSize = 10;
+
+    // map signed integers to unsigned ones so that values of small magnitude get short varints,
+    // i.e. 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+    constexpr uint64_t EncodeZigZag(int64_t value) noexcept
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    constexpr int64_t DecodeZigZag(uint64_t value) noexcept
+    {
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
     class BinaryWriter
     {
     public:
@@ -21,6 +38,26 @@ namespace eds::binary
         {
             data_.insert(data_.end(), begin, end);
         }
+
+        // LEB128, low 7 bits first and the high bit of each byte set if more bytes follow
+        void WriteVarint(uint64_t value)
+        {
+            uint8_t buf[kMaxVarintSize];
+
+            int len = 0;
+            for (; value >= 0x80; value >>= 7)
+            {
+                buf[len++] = static_cast<uint8_t>(value | 0x80);
+            }
+            buf[len++] = static_cast<uint8_t>(value);
+
+            Write(buf, buf + len);
+        }
+        void WriteSignedVarint(int64_t value)
+        {
+            WriteVarint(EncodeZigZag(value));
+        }
+
         void Clear()
         {
             data_.clear();
@@ -62,6 +99,43 @@ namespace eds::binary
             memcpy(dest, data_.data() + cursor_, len);
             cursor_ += len;
         }
+
+        uint64_t ReadVarint()
+        {
+            if (static_cast<size_t>(cursor_) < data_.size() && data_[cursor_] < 0x80)
+            {
+                // one byte varints are the most common
+                return data_[cursor_++];
+            }
+
+            // at most kMaxVarintSize bytes are looked at, so the loop needs no other bound check
+            auto p   = data_.data() + cursor_;
+            auto len = std::min<size_t>(data_.size() - cursor_, kMaxVarintSize);
+
+            uint64_t value = 0;
+            for (size_t i = 0; i < len; ++i)
+            {
+                // the last byte holds only the highest bit of 64
+                if (i == kMaxVarintSize - 1 && p[i] > 1)
+                {
+                    throw 0; // overlong varint
+                }
+
+                value |= static_cast<uint64_t>(p[i] & 0x7F) << (7 * i);
+                if (p[i] < 0x80)
+                {
+                    cursor_ += static_cast<int>(i + 1);
+                    return value;
+                }
+            }
+
+            throw 0; // truncated or overlong varint
+        }
+        int64_t ReadSignedVarint()
+        {
+            return DecodeZigZag(ReadVarint());
+        }
+
         void Reset()
         {
             cursor_ = 0;
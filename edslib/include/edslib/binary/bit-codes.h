@@ -0,0 +1,140 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/binary/bit-ops.h"
+#include <cstdint>
+
+// variable-length codes for small integers on MSB-first bit streams
+//
+// decoders count the leading zeros of a 32-bit peek instead of reading bit by bit, so a code
+// shorter than 33 bits is decoded with one peek and one skip
+namespace eds
+{
+    // Elias gamma, value >= 1 is written as floor(log2(value)) zeros followed by value in binary
+    inline void WriteEliasGamma(BitEmitter& emit, uint32_t value)
+    {
+        assert(value != 0);
+
+        auto n = 31 - detail::CountLeadingZeros(value);
+        if (2 * n + 1 <= 32)
+        {
+            // leading zeros are written as part of value
+            emit.Write(value, 2 * n + 1);
+        }
+        else
+        {
+            emit.Write(0, n);
+            emit.Write(value, n + 1);
+        }
+    }
+
+    template <typename TIter>
+    inline uint32_t ReadEliasGamma(BitReader<TIter>& reader)
+    {
+        auto bits = reader.Peek(32);
+        if (bits == 0)
+        {
+            throw 0; // not a valid code for 32-bit value
+        }
+
+        // bits past the end are peeked as zero, so the code must be checked to be in the stream
+        auto n = detail::CountLeadingZeros(bits);
+        if (reader.RemainingSize() < static_cast<size_t>(2 * n + 1))
+        {
+            throw 0; // code runs past the end
+        }
+
+        if (2 * n + 1 <= 32)
+        {
+            reader.Skip(2 * n + 1);
+            return bits >> (31 - 2 * n);
+        }
+
+        reader.Skip(n);
+        return reader.Read(n + 1);
+    }
+
+    // Elias delta, value >= 1 is written as floor(log2(value)) + 1 in Elias gamma followed by value
+    // in binary without its leading one, it's shorter than gamma for values larger than 31
+    inline void WriteEliasDelta(BitEmitter& emit, uint32_t value)
+    {
+        assert(value != 0);
+
+        auto n = 31 - detail::CountLeadingZeros(value);
+        WriteEliasGamma(emit, n + 1);
+        if (n > 0)
+        {
+            emit.Write(value, n);
+        }
+    }
+
+    template <typename TIter>
+    inline uint32_t ReadEliasDelta(BitReader<TIter>& reader)
+    {
+        auto n = ReadEliasGamma(reader) - 1;
+        if (n > 31)
+        {
+            throw 0; // not a valid code for 32-bit value
+        }
+        if (reader.RemainingSize() < n)
+        {
+            throw 0; // code runs past the end
+        }
+
+        return n > 0 ? (1U << n) | reader.Read(n) : 1;
+    }
+
+    // Golomb-Rice with parameter k, value is written as value >> k in unary, i.e. zeros terminated
+    // by a one, followed by the low k bits of value
+    // k close to log2 of the mean value gives the shortest codes for geometric distributions
+    inline void WriteRice(BitEmitter& emit, uint32_t value, int k)
+    {
+        assert(k >= 0 && k <= 31);
+
+        for (auto q = value >> k; q > 0;)
+        {
+            auto n = q < 32 ? static_cast<int>(q) : 32;
+            emit.Write(0, n);
+            q -= n;
+        }
+
+        // the terminating one and the remainder
+        emit.Write((1U << k) | value, k + 1);
+    }
+
+    template <typename TIter>
+    inline uint32_t ReadRice(BitReader<TIter>& reader, int k)
+    {
+        assert(k >= 0 && k <= 31);
+
+        uint32_t q = 0;
+        auto bits  = reader.Peek(32);
+        while (bits == 0)
+        {
+            if (reader.RemainingSize() < 32)
+            {
+                throw 0; // unary part runs past the end
+            }
+
+            q += 32;
+            reader.Skip(32);
+            bits = reader.Peek(32);
+        }
+
+        auto n = detail::CountLeadingZeros(bits);
+        if (reader.RemainingSize() < static_cast<size_t>(n + 1 + k))
+        {
+            throw 0; // code runs past the end
+        }
+
+        reader.Skip(n + 1);
+        q += n;
+
+        return k > 0 ? (q << k) | reader.Read(k) : q;
+    }
+}
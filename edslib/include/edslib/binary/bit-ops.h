@@ -1,129 +1,328 @@
 #pragma once
 #include "../type-utils.h"
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <cassert>
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <stdlib.h>
+#endif
+
 // Bit operations
 namespace eds
 {
-    template <typename TIter>
+    namespace detail
+    {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        static constexpr bool kLittleEndianHost = false;
+#else
+        static constexpr bool kLittleEndianHost = true;
+#endif
+
+        inline uint32_t ByteSwap(uint32_t x) noexcept
+        {
+#if defined(_MSC_VER)
+            return _byteswap_ulong(x);
+#elif defined(__GNUC__)
+            return __builtin_bswap32(x);
+#else
+            return (x >> 24) | ((x >> 8) & 0xFF00) | ((x << 8) & 0xFF0000) | (x << 24);
+#endif
+        }
+
+        inline uint64_t ByteSwap(uint64_t x) noexcept
+        {
+#if defined(_MSC_VER)
+            return _byteswap_uint64(x);
+#elif defined(__GNUC__)
+            return __builtin_bswap64(x);
+#else
+            return (static_cast<uint64_t>(ByteSwap(static_cast<uint32_t>(x))) << 32) |
+                   ByteSwap(static_cast<uint32_t>(x >> 32));
+#endif
+        }
+
+        // x must not be zero
+        inline int CountLeadingZeros(uint32_t x) noexcept
+        {
+            assert(x != 0);
+
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse(&index, x);
+            return 31 - static_cast<int>(index);
+#elif defined(__GNUC__)
+            return __builtin_clz(x);
+#else
+            int n = 0;
+            for (; (x & 0x80000000) == 0; x <<= 1)
+            {
+                n += 1;
+            }
+            return n;
+#endif
+        }
+
+        inline uint64_t LoadBigEndian64(const uint8_t* p) noexcept
+        {
+            uint64_t x;
+            std::memcpy(&x, p, sizeof(x));
+
+            return kLittleEndianHost ? ByteSwap(x) : x;
+        }
+
+        inline void StoreBigEndian64(uint8_t* p, uint64_t x) noexcept
+        {
+            x = kLittleEndianHost ? ByteSwap(x) : x;
+            std::memcpy(p, &x, sizeof(x));
+        }
+
+        inline uint64_t LoadLittleEndian64(const uint8_t* p) noexcept
+        {
+            uint64_t x;
+            std::memcpy(&x, p, sizeof(x));
+
+            return kLittleEndianHost ? x : ByteSwap(x);
+        }
+
+        inline void StoreLittleEndian64(uint8_t* p, uint64_t x) noexcept
+        {
+            x = kLittleEndianHost ? x : ByteSwap(x);
+            std::memcpy(p, &x, sizeof(x));
+        }
+    } // namespace detail
+
+    //
+    // bit orders define how bits of the stream line up in the 64-bit buffer of BitReader and
+    // BitEmitter, an offset into the buffer counts bits from where the next bit is
+    //
+
+    // bits are packed from the most significant end of each byte and a value is packed from its
+    // most significant bit, e.g. LZW of compress(1), JPEG
+    //
+    // next bit is at the most significant end of the buffer
+    struct MsbFirst
+    {
+        static uint64_t LoadWord(const uint8_t* p) noexcept { return detail::LoadBigEndian64(p); }
+        static void StoreWord(uint8_t* p, uint64_t word) noexcept { detail::StoreBigEndian64(p, word); }
+
+        // bits of a word loaded, or a byte, or a value of len bits, placed at offset of the buffer
+        static uint64_t Place(uint64_t word, int offset) noexcept { return word >> offset; }
+        static uint64_t PlaceByte(uint8_t b, int offset) noexcept { return (uint64_t{b} << 56) >> offset; }
+        static uint64_t PlaceValue(uint64_t value, int len, int offset) noexcept { return value << (64 - offset - len); }
+
+        // the next len bits in the buffer, and the buffer with len bits consumed
+        static uint32_t Front(uint64_t buffer, int len) noexcept { return static_cast<uint32_t>(buffer >> (64 - len)); }
+        static uint64_t Advance(uint64_t buffer, int len) noexcept { return buffer << len; }
+    };
+
+    // bits are packed from the least significant end of each byte and a value is packed from its
+    // least significant bit, e.g. GIF, DEFLATE
+    //
+    // next bit is at the least significant end of the buffer
+    struct LsbFirst
+    {
+        static uint64_t LoadWord(const uint8_t* p) noexcept { return detail::LoadLittleEndian64(p); }
+        static void StoreWord(uint8_t* p, uint64_t word) noexcept { detail::StoreLittleEndian64(p, word); }
+
+        static uint64_t Place(uint64_t word, int offset) noexcept { return word << offset; }
+        static uint64_t PlaceByte(uint8_t b, int offset) noexcept { return uint64_t{b} << offset; }
+        static uint64_t PlaceValue(uint64_t value, int, int offset) noexcept { return value << offset; }
+
+        static uint32_t Front(uint64_t buffer, int len) noexcept { return static_cast<uint32_t>(buffer & (~uint64_t{0} >> (64 - len))); }
+        static uint64_t Advance(uint64_t buffer, int len) noexcept { return buffer >> len; }
+    };
+
+    // BitReader reads bits in TOrder through a 64-bit buffer
+    // the buffer is refilled a word at a time if TIter is a pointer, and byte by byte otherwise
+    template <typename TIter, typename TOrder = MsbFirst>
     class BitReader
     {
         static_assert(type::Constraint<TIter>(type::is_iterator_of<uint8_t>), "TIter must be an iterator type of uint8_t");
 
+        static constexpr bool kWordLoad = std::is_pointer_v<TIter>;
+
     public:
         BitReader(TIter begin, TIter end)
             : begin_(begin), end_(end), cursor_(begin) {}
 
-        bool Exhausted() const { return cursor_ == end_; }
+        bool Exhausted() const { return bit_count_ == 0 && cursor_ == end_; }
 
-        int Offset() const { return offset_; }
-        int RemainingSize() const { return std::distance(cursor_, end_) * 8 - offset_; }
+        // bit offset in the current byte
+        int Offset() const { return -bit_count_ & 7; }
+        size_t RemainingSize() const { return static_cast<size_t>(std::distance(cursor_, end_)) * 8 + bit_count_; }
 
         void Reset()
         {
-            offset_ = 0;
-            cursor_ = begin_;
+            cursor_    = begin_;
+            buffer_    = 0;
+            bit_count_ = 0;
         }
 
-        uint32_t Read(int len)
+        // returns the next len bits without consuming them, bits past the end read as zero
+        uint32_t Peek(int len)
         {
             assert(len > 0 && len <= 32);
 
-            uint32_t result = 0;
-            while (len != 0)
+            if (bit_count_ < len)
             {
-                auto x = std::min(len, 8 - offset_);
+                Refill();
+            }
+
+            return TOrder::Front(buffer_, len);
+        }
 
-                len -= x;
-                result <<= x;
-                result |= ReadInternal(x);
+        void Skip(int len)
+        {
+            assert(len > 0 && len <= 32);
+
+            if (bit_count_ < len)
+            {
+                Refill();
             }
 
-            return result;
+            assert(len <= bit_count_);
+            buffer_ = TOrder::Advance(buffer_, len);
+            bit_count_ -= len;
         }
 
-    private:
-        // read a sequence of bits from the current byte
-        uint32_t ReadInternal(int len)
+        uint32_t Read(int len)
         {
-            using namespace std;
+            auto result = Peek(len);
+            Skip(len);
 
-            static constexpr uint8_t bitmasks[] = {
-                /*dummy*/ 0, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF};
+            return result;
+        }
 
-            auto data = *cursor_;
-            data >>= 8 - len - offset_;
-            data &= bitmasks[len];
+    private:
+        // top up the buffer to at least 57 bits, unless the input runs out
+        void Refill()
+        {
+            if constexpr (kWordLoad)
+            {
+                if (end_ - cursor_ >= 8)
+                {
+                    // bits loaded beyond the whole bytes counted are the same as those the next
+                    // refill ORs in place, so they're harmless
+                    buffer_ |= TOrder::Place(TOrder::LoadWord(cursor_), bit_count_);
+                    cursor_ += (63 - bit_count_) >> 3;
+                    bit_count_ |= 56;
+                    return;
+                }
+            }
 
-            offset_ += len;
-            if (offset_ == 8)
+            while (bit_count_ <= 56 && cursor_ != end_)
             {
+                buffer_ |= TOrder::PlaceByte(static_cast<uint8_t>(*cursor_), bit_count_);
                 ++cursor_;
-                offset_ = 0;
+                bit_count_ += 8;
             }
-
-            return data;
         }
 
         TIter begin_;
         TIter end_;
-
-        int offset_ = 0;
         TIter cursor_;
+
+        // bits beyond bit_count_ are not consumable
+        uint64_t buffer_ = 0;
+        int bit_count_   = 0;
     };
 
-    class BitEmitter
+    // BasicBitEmitter writes bits in TOrder through a 64-bit buffer
+    //
+    // each write stores the whole buffer and advances by the bytes completed, so there's no branch
+    // on how many bytes are flushed. data_ is kept at least 8 bytes ahead of the bytes written
+    template <typename TOrder = MsbFirst>
+    class BasicBitEmitter
     {
     public:
+        // bytes written, the last one is padded with zero if it's partial
         const auto& Value() const
         {
+            Sync();
             return data_;
         }
 
         auto Export()
         {
-            return std::move(data_);
+            Sync();
+
+            auto result = std::move(data_);
+            Reset();
+
+            return result;
         }
 
         void Reset()
         {
-            offset_ = 0;
             data_.clear();
+            size_      = 0;
+            buffer_    = 0;
+            bit_count_ = 0;
+        }
+
+        // count of bytes whose bits are all written
+        size_t CompleteSize() const
+        {
+            return size_;
+        }
+
+        // remove the first n bytes, which must be complete, e.g. after they're sent elsewhere
+        void Drain(size_t n)
+        {
+            assert(n <= CompleteSize());
+
+            Sync();
+            data_.erase(data_.begin(), data_.begin() + n);
+            size_ -= n;
         }
 
         void Write(uint32_t data, int len)
         {
             assert(len > 0 && len <= 32);
 
-            while (len != 0)
+            if (data_.size() < size_ + 8)
             {
-                data &= ~0 >> (32 - len);
+                Grow();
+            }
 
-                auto x = std::min(8 - offset_, len);
-                auto t = data >> (len - x);
+            buffer_ |= TOrder::PlaceValue(data & (~uint32_t{0} >> (32 - len)), len, bit_count_);
+            bit_count_ += len;
+            TOrder::StoreWord(data_.data() + size_, buffer_);
 
-                WriteInternal(t, x);
-                len -= x;
-            }
+            // at most 39 bits are pending, so the shift is less than 64
+            auto n = bit_count_ >> 3;
+            size_ += n;
+            buffer_ = TOrder::Advance(buffer_, n * 8);
+            bit_count_ &= 7;
         }
 
     private:
-        void WriteInternal(uint8_t data, int len)
+        void Grow()
         {
-            if (data_.empty() || offset_ == 8)
-            {
-                data_.push_back(0);
-                offset_ = 0;
-            }
+            data_.resize(std::max<size_t>(64, (size_ + 8) * 2));
+        }
 
-            data_.back() |= data << (8 - offset_ - len);
-            offset_ += len;
+        // trim data_ to the bytes written, the partial byte is already stored padded
+        void Sync() const
+        {
+            data_.resize(size_ + (bit_count_ > 0 ? 1 : 0));
         }
 
-        int offset_ = 0;
-        std::vector<uint8_t> data_;
+        // bytes after size_ are spare, except for the partial byte
+        mutable std::vector<uint8_t> data_;
+        size_t size_ = 0;
+
+        // pending bits, less than 8 between calls
+        uint64_t buffer_ = 0;
+        int bit_count_   = 0;
     };
-}
\ No newline at end of file
+
+    using BitEmitter = BasicBitEmitter<>;
+}
@@ -0,0 +1,230 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/binary/bit-ops.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EDSLIB_BITPACK_AVX2 1
+#include <immintrin.h>
+#endif
+
+// bulk packing of fixed-width integers, the layout is the same as writing each value with
+// BitEmitter, i.e. MSB-first and without padding between values
+namespace eds
+{
+    namespace detail
+    {
+        template <typename TFunc, int... Ws>
+        inline void DispatchBitWidth(int width, TFunc&& fn, std::integer_sequence<int, Ws...>)
+        {
+            ((width == Ws + 1 ? (fn(std::integral_constant<int, Ws + 1>{}), true) : false) || ...);
+        }
+
+        // invoke fn with std::integral_constant<int, width>, so that kernels are instantiated for
+        // each width with constant shifts
+        template <typename TFunc>
+        inline void DispatchBitWidth(int width, TFunc&& fn)
+        {
+            assert(width >= 1 && width <= 32);
+            DispatchBitWidth(width, fn, std::make_integer_sequence<int, 32>{});
+        }
+
+        // count of leading values that could be read with an 8-byte load within size bytes
+        inline size_t CountWordLoadable(size_t size, size_t n, int width) noexcept
+        {
+            if (size < 8)
+            {
+                return 0;
+            }
+
+            // value i starts at byte i * width / 8, which must be no more than size - 8
+            return std::min(n, (size - 8) * 8 / width + 1);
+        }
+
+        template <int Width>
+        inline void PackBitsScalar(const uint32_t* in, size_t n, uint8_t* out) noexcept
+        {
+            constexpr auto kMask = ~uint64_t{0} >> (64 - Width);
+
+            // pending bits at the most significant end, flushed 32 bits at a time
+            uint64_t buffer = 0;
+            int count       = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                buffer |= (in[i] & kMask) << (64 - Width - count);
+                count += Width;
+
+                if (count >= 32)
+                {
+                    auto word = static_cast<uint32_t>(buffer >> 32);
+                    word      = kLittleEndianHost ? ByteSwap(word) : word;
+                    std::memcpy(out, &word, 4);
+
+                    out += 4;
+                    buffer <<= 32;
+                    count -= 32;
+                }
+            }
+
+            for (; count > 0; count -= 8)
+            {
+                *out++ = static_cast<uint8_t>(buffer >> 56);
+                buffer <<= 8;
+            }
+        }
+
+        // unpack values [begin, end), which must be word loadable
+        template <int Width>
+        inline void UnpackBitsScalar(const uint8_t* in, size_t begin, size_t end, uint32_t* out) noexcept
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                auto bit  = i * Width;
+                auto word = LoadBigEndian64(in + bit / 8);
+
+                out[i] = static_cast<uint32_t>((word << (bit % 8)) >> (64 - Width));
+            }
+        }
+
+        // unpack values [begin, n) near the end of input, which are not word loadable
+        inline void UnpackBitsTail(const uint8_t* in, size_t size, size_t begin, size_t n, int width, uint32_t* out)
+        {
+            if (begin == n)
+            {
+                return;
+            }
+
+            auto bit = begin * width;
+            BitReader<const uint8_t*> reader{in + bit / 8, in + size};
+            if (bit % 8 != 0)
+            {
+                reader.Skip(static_cast<int>(bit % 8));
+            }
+
+            for (auto i = begin; i < n; ++i)
+            {
+                out[i] = reader.Read(width);
+            }
+        }
+
+#if defined(EDSLIB_BITPACK_AVX2)
+        inline bool HasAvx2() noexcept
+        {
+            static const bool has_avx2 = __builtin_cpu_supports("avx2");
+            return has_avx2;
+        }
+
+        // unpack 4 values wider than 25 bits at given bit offsets from base
+        __attribute__((target("avx2"))) inline __m256i UnpackHalfAvx2(const long long* base, __m128i bits, __m256i bswap64, __m128i right) noexcept
+        {
+            auto words = _mm256_i32gather_epi64(base, _mm_srli_epi32(bits, 3), 1);
+            words      = _mm256_shuffle_epi8(words, bswap64);
+            words      = _mm256_sllv_epi64(words, _mm256_cvtepu32_epi64(_mm_and_si128(bits, _mm_set1_epi32(7))));
+
+            return _mm256_srl_epi64(words, right);
+        }
+
+        // unpack 8 values at a time with gathers, returns count of values unpacked
+        // values before n must be word loadable
+        __attribute__((target("avx2"))) inline size_t UnpackBitsAvx2(const uint8_t* in, size_t n, int width, uint32_t* out) noexcept
+        {
+            const auto lane_bits = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(width));
+
+            size_t i = 0;
+            if (width <= 25)
+            {
+                // a value and its bit offset in the first byte fit in a 32-bit load
+                const auto bswap32 = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+                const auto right   = _mm_cvtsi32_si128(32 - width);
+
+                for (; i + 8 <= n; i += 8)
+                {
+                    auto bit  = i * width;
+                    auto base = reinterpret_cast<const int*>(in + bit / 8);
+                    auto bits = _mm256_add_epi32(lane_bits, _mm256_set1_epi32(static_cast<int>(bit % 8)));
+
+                    auto words = _mm256_i32gather_epi32(base, _mm256_srli_epi32(bits, 3), 1);
+                    words      = _mm256_shuffle_epi8(words, bswap32);
+                    words      = _mm256_sllv_epi32(words, _mm256_and_si256(bits, _mm256_set1_epi32(7)));
+                    words      = _mm256_srl_epi32(words, right);
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), words);
+                }
+            }
+            else
+            {
+                // 64-bit loads, 4 values in each half
+                const auto bswap64 = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                                      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+                const auto right   = _mm_cvtsi32_si128(64 - width);
+
+                for (; i + 8 <= n; i += 8)
+                {
+                    auto bit  = i * width;
+                    auto base = reinterpret_cast<const long long*>(in + bit / 8);
+                    auto bits = _mm256_add_epi32(lane_bits, _mm256_set1_epi32(static_cast<int>(bit % 8)));
+
+                    auto lo = UnpackHalfAvx2(base, _mm256_castsi256_si128(bits), bswap64, right);
+                    auto hi = UnpackHalfAvx2(base, _mm256_extracti128_si256(bits, 1), bswap64, right);
+
+                    // take the low half of each 64-bit lane, in order
+                    auto words = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+                    words      = _mm256_permute4x64_epi64(words, _MM_SHUFFLE(3, 1, 2, 0));
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), words);
+                }
+            }
+
+            return i;
+        }
+#endif
+    } // namespace detail
+
+    // bytes taken by n values packed in width bits
+    constexpr size_t PackedBitSize(size_t n, int width) noexcept
+    {
+        return (n * width + 7) / 8;
+    }
+
+    // pack the low width bits of n values into PackedBitSize(n, width) bytes of out
+    inline void PackBits(const uint32_t* in, size_t n, int width, uint8_t* out) noexcept
+    {
+        detail::DispatchBitWidth(width, [&](auto w) {
+            detail::PackBitsScalar<decltype(w)::value>(in, n, out);
+        });
+    }
+
+    // unpack n values of width bits from PackedBitSize(n, width) bytes of in
+    // an AVX2 kernel is used if the processor supports it
+    inline void UnpackBits(const uint8_t* in, size_t n, int width, uint32_t* out)
+    {
+        auto size     = PackedBitSize(n, width);
+        auto loadable = detail::CountWordLoadable(size, n, width);
+
+        size_t done = 0;
+#if defined(EDSLIB_BITPACK_AVX2)
+        if (detail::HasAvx2())
+        {
+            done = detail::UnpackBitsAvx2(in, loadable, width, out);
+        }
+#endif
+
+        detail::DispatchBitWidth(width, [&](auto w) {
+            detail::UnpackBitsScalar<decltype(w)::value>(in, done, loadable, out);
+        });
+        detail::UnpackBitsTail(in, size, loadable, n, width, out);
+    }
+}
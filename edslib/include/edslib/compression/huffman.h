@@ -0,0 +1,619 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/binary/bit-codes.h"
+#include "edslib/binary/bit-ops.h"
+#include "edslib/compression/lzw.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// canonical Huffman coding on MSB-first bit streams
+//
+// a code is described by the code length of each symbol, 0 if the symbol is not used. codes are
+// assigned in order of length and then of symbol, so lengths are all a decoder needs
+namespace eds::compression
+{
+    static constexpr int kMaxHuffmanCodeLength = 20;
+
+    // symbols are stored in 16 bits by the decoder
+    static constexpr size_t kMaxHuffmanAlphabetSize = 1 << 16;
+
+    namespace detail
+    {
+        // bits of the lookup table of HuffmanDecoder, codes longer than this take the slow path
+        static constexpr int kHuffmanTableBits = 11;
+
+        // canonical code of each symbol
+        inline std::vector<uint32_t> AssignHuffmanCodes(const std::vector<uint8_t>& lengths)
+        {
+            uint32_t count[kMaxHuffmanCodeLength + 1] = {};
+            for (auto len : lengths)
+            {
+                count[len] += 1;
+            }
+            count[0] = 0;
+
+            uint32_t next_code[kMaxHuffmanCodeLength + 1] = {};
+            for (int len = 1; len <= kMaxHuffmanCodeLength; ++len)
+            {
+                next_code[len] = (next_code[len - 1] + count[len - 1]) << 1;
+            }
+
+            std::vector<uint32_t> codes(lengths.size());
+            for (size_t i = 0; i < lengths.size(); ++i)
+            {
+                if (lengths[i] != 0)
+                {
+                    codes[i] = next_code[lengths[i]]++;
+                }
+            }
+
+            return codes;
+        }
+
+        // stored as two 32-bit halves, high half first
+        inline void WriteHuffmanCount(BitEmitter& emit, uint64_t count)
+        {
+            emit.Write(static_cast<uint32_t>(count >> 32), 32);
+            emit.Write(static_cast<uint32_t>(count), 32);
+        }
+
+        template <typename TIter>
+        inline uint64_t ReadHuffmanCount(BitReader<TIter>& reader)
+        {
+            if (reader.RemainingSize() < 64)
+            {
+                throw 0; // not a valid huffman stream
+            }
+
+            uint64_t high = reader.Read(32);
+            return (high << 32) | reader.Read(32);
+        }
+    } // namespace detail
+
+    // code lengths of a Huffman code for symbol frequencies, no longer than max_length
+    //
+    // codes exceeding max_length are cut down to it and then codes of the longest length below
+    // max_length are lengthened one by one until the code is valid again, which is close to optimal
+    // as only rare symbols are affected
+    inline std::vector<uint8_t> BuildHuffmanLengths(const uint64_t* freqs, size_t alphabet_size, int max_length = kMaxHuffmanCodeLength)
+    {
+        assert(max_length > 0 && max_length <= kMaxHuffmanCodeLength);
+        assert(alphabet_size <= (size_t{1} << max_length));
+
+        std::vector<uint8_t> lengths(alphabet_size);
+
+        // symbols used, in order of descending frequency
+        std::vector<uint32_t> symbols;
+        for (size_t i = 0; i < alphabet_size; ++i)
+        {
+            if (freqs[i] != 0)
+            {
+                symbols.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        std::stable_sort(symbols.begin(), symbols.end(), [&](uint32_t x, uint32_t y) { return freqs[x] > freqs[y]; });
+
+        if (symbols.size() <= 1)
+        {
+            // a single symbol still takes one bit, so that the stream could be read
+            for (auto s : symbols)
+            {
+                lengths[s] = 1;
+            }
+
+            return lengths;
+        }
+
+        // build the tree, leaves are [0, n) and internal nodes follow
+        auto n = symbols.size();
+        std::vector<uint32_t> parent(2 * n - 1);
+
+        using Node = std::pair<uint64_t, uint32_t>;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            queue.push({freqs[symbols[i]], i});
+        }
+        for (auto next = static_cast<uint32_t>(n); queue.size() > 1; ++next)
+        {
+            auto x = queue.top();
+            queue.pop();
+            auto y = queue.top();
+            queue.pop();
+
+            parent[x.second] = next;
+            parent[y.second] = next;
+            queue.push({x.first + y.first, next});
+        }
+
+        // depth of each node, parents always come after children
+        std::vector<int> depth(2 * n - 1);
+        for (auto i = 2 * n - 2; i-- > 0;)
+        {
+            depth[i] = depth[parent[i]] + 1;
+        }
+
+        // count of codes in each length, with those too long cut down
+        int count[kMaxHuffmanCodeLength + 1] = {};
+        for (size_t i = 0; i < n; ++i)
+        {
+            count[std::min(depth[i], max_length)] += 1;
+        }
+
+        // Kraft sum in units of 2^-max_length, the code is valid if it's no more than 1
+        uint64_t kraft = 0;
+        for (int len = 1; len <= max_length; ++len)
+        {
+            kraft += static_cast<uint64_t>(count[len]) << (max_length - len);
+        }
+        while (kraft > (uint64_t{1} << max_length))
+        {
+            auto len = max_length - 1;
+            while (count[len] == 0)
+            {
+                len -= 1;
+            }
+
+            count[len] -= 1;
+            count[len + 1] += 1;
+            kraft -= uint64_t{1} << (max_length - len - 1);
+        }
+
+        // more frequent symbols take shorter codes
+        size_t i = 0;
+        for (int len = 1; len <= max_length; ++len)
+        {
+            for (int j = 0; j < count[len]; ++j)
+            {
+                lengths[symbols[i++]] = static_cast<uint8_t>(len);
+            }
+        }
+
+        return lengths;
+    }
+
+    // code lengths are written in Elias gamma as length + 1, and a zero length is followed by the
+    // count of zero lengths after it, so unused symbols of a large alphabet take little space
+    inline void WriteHuffmanLengths(BitEmitter& emit, const std::vector<uint8_t>& lengths)
+    {
+        for (size_t i = 0; i < lengths.size(); ++i)
+        {
+            WriteEliasGamma(emit, lengths[i] + 1);
+            if (lengths[i] == 0)
+            {
+                auto j = i + 1;
+                while (j < lengths.size() && lengths[j] == 0)
+                {
+                    j += 1;
+                }
+
+                WriteEliasGamma(emit, static_cast<uint32_t>(j - i));
+                i = j - 1;
+            }
+        }
+    }
+
+    template <typename TIter>
+    inline std::vector<uint8_t> ReadHuffmanLengths(BitReader<TIter>& reader, size_t alphabet_size)
+    {
+        std::vector<uint8_t> lengths;
+        lengths.reserve(alphabet_size);
+        while (lengths.size() < alphabet_size)
+        {
+            auto len = ReadEliasGamma(reader) - 1;
+            if (len > kMaxHuffmanCodeLength)
+            {
+                throw 0; // not a valid huffman stream
+            }
+
+            if (len != 0)
+            {
+                lengths.push_back(static_cast<uint8_t>(len));
+                continue;
+            }
+
+            auto run = ReadEliasGamma(reader);
+            if (run > alphabet_size - lengths.size())
+            {
+                throw 0; // not a valid huffman stream
+            }
+            lengths.resize(lengths.size() + run);
+        }
+
+        return lengths;
+    }
+
+    class HuffmanEncoder
+    {
+    public:
+        explicit HuffmanEncoder(std::vector<uint8_t> lengths)
+            : lengths_(std::move(lengths)), codes_(detail::AssignHuffmanCodes(lengths_)) {}
+
+        const auto& Lengths() const noexcept
+        {
+            return lengths_;
+        }
+
+        // symbol must have a code
+        void Write(BitEmitter& emit, uint32_t symbol) const
+        {
+            assert(symbol < lengths_.size() && lengths_[symbol] != 0);
+            emit.Write(codes_[symbol], lengths_[symbol]);
+        }
+
+    private:
+        std::vector<uint8_t> lengths_;
+        std::vector<uint32_t> codes_;
+    };
+
+    // HuffmanDecoder reads symbols through a lookup table indexed by the next kHuffmanTableBits bits
+    //
+    // an entry holds up to two symbols whose codes fit in the table bits together, so most symbols
+    // of a skewed distribution are decoded two at a time. longer codes are decoded with the
+    // canonical code ranges of each length
+    class HuffmanDecoder
+    {
+    public:
+        // throws if lengths don't describe a valid code
+        explicit HuffmanDecoder(const std::vector<uint8_t>& lengths)
+        {
+            using detail::kHuffmanTableBits;
+
+            if (lengths.size() > kMaxHuffmanAlphabetSize)
+            {
+                throw 0; // not a valid huffman code
+            }
+
+            uint64_t kraft = 0;
+            for (auto len : lengths)
+            {
+                if (len > kMaxHuffmanCodeLength)
+                {
+                    throw 0; // not a valid huffman code
+                }
+
+                count_[len] += 1;
+                kraft += len != 0 ? uint64_t{1} << (kMaxHuffmanCodeLength - len) : 0;
+            }
+            count_[0] = 0;
+
+            if (kraft > (uint64_t{1} << kMaxHuffmanCodeLength))
+            {
+                throw 0; // not a valid huffman code
+            }
+
+            // symbols sorted by code, and the first code and its index of each length
+            uint32_t code  = 0;
+            uint32_t index = 0;
+            for (int len = 1; len <= kMaxHuffmanCodeLength; ++len)
+            {
+                code              = (code + count_[len - 1]) << 1;
+                first_code_[len]  = code;
+                first_index_[len] = index;
+                index += count_[len];
+            }
+
+            sorted_.resize(index);
+            auto codes = detail::AssignHuffmanCodes(lengths);
+            for (size_t s = 0; s < lengths.size(); ++s)
+            {
+                auto len = lengths[s];
+                if (len != 0)
+                {
+                    sorted_[first_index_[len] + codes[s] - first_code_[len]] = static_cast<uint16_t>(s);
+                }
+            }
+
+            // fill the table, codes are prefix free so ranges of different symbols don't overlap
+            table_.resize(size_t{1} << kHuffmanTableBits);
+            for (int len1 = 1; len1 <= kHuffmanTableBits; ++len1)
+            {
+                for (auto i = first_index_[len1]; i < first_index_[len1] + count_[len1]; ++i)
+                {
+                    auto rest = kHuffmanTableBits - len1;
+                    auto base = (first_code_[len1] + (i - first_index_[len1])) << rest;
+                    std::fill_n(table_.begin() + base, size_t{1} << rest, TableEntry{{sorted_[i], 0}, 1, static_cast<uint8_t>(len1), static_cast<uint8_t>(len1)});
+
+                    // second symbols whose codes fit in the bits left
+                    for (int len2 = 1; len2 <= rest; ++len2)
+                    {
+                        for (auto j = first_index_[len2]; j < first_index_[len2] + count_[len2]; ++j)
+                        {
+                            auto index2 = base | ((first_code_[len2] + (j - first_index_[len2])) << (rest - len2));
+                            std::fill_n(table_.begin() + index2, size_t{1} << (rest - len2), TableEntry{{sorted_[i], sorted_[j]}, 2, static_cast<uint8_t>(len1), static_cast<uint8_t>(len1 + len2)});
+                        }
+                    }
+                }
+            }
+        }
+
+        template <typename TIter>
+        uint32_t Read(BitReader<TIter>& reader) const
+        {
+            const auto& entry = table_[reader.Peek(detail::kHuffmanTableBits)];
+            if (entry.count == 0)
+            {
+                return ReadLong(reader);
+            }
+
+            Consume(reader, entry.first_length);
+            return entry.symbols[0];
+        }
+
+        // read n symbols into out, throws if the stream runs out or holds an invalid code
+        template <typename TIter, typename TOut>
+        void Read(BitReader<TIter>& reader, TOut* out, size_t n) const
+        {
+            size_t i = 0;
+            while (i < n)
+            {
+                const auto& entry = table_[reader.Peek(detail::kHuffmanTableBits)];
+                if (entry.count == 2 && n - i >= 2)
+                {
+                    Consume(reader, entry.length);
+                    out[i]     = static_cast<TOut>(entry.symbols[0]);
+                    out[i + 1] = static_cast<TOut>(entry.symbols[1]);
+                    i += 2;
+                }
+                else if (entry.count != 0)
+                {
+                    Consume(reader, entry.first_length);
+                    out[i++] = static_cast<TOut>(entry.symbols[0]);
+                }
+                else
+                {
+                    out[i++] = static_cast<TOut>(ReadLong(reader));
+                }
+            }
+        }
+
+    private:
+        struct TableEntry
+        {
+            uint16_t symbols[2];
+
+            // count of symbols, 0 if the code is longer than the table bits or invalid
+            uint8_t count;
+            uint8_t first_length;
+            uint8_t length;
+        };
+
+        template <typename TIter>
+        static void Consume(BitReader<TIter>& reader, int len)
+        {
+            if (reader.RemainingSize() < static_cast<size_t>(len))
+            {
+                throw 0; // huffman stream runs out
+            }
+
+            reader.Skip(len);
+        }
+
+        template <typename TIter>
+        uint32_t ReadLong(BitReader<TIter>& reader) const
+        {
+            auto bits = reader.Peek(kMaxHuffmanCodeLength);
+            for (int len = detail::kHuffmanTableBits + 1; len <= kMaxHuffmanCodeLength; ++len)
+            {
+                auto offset = (bits >> (kMaxHuffmanCodeLength - len)) - first_code_[len];
+                if (offset < count_[len])
+                {
+                    Consume(reader, len);
+                    return sorted_[first_index_[len] + offset];
+                }
+            }
+
+            throw 0; // not a valid huffman code
+        }
+
+        std::vector<TableEntry> table_;
+
+        uint32_t count_[kMaxHuffmanCodeLength + 1]       = {};
+        uint32_t first_code_[kMaxHuffmanCodeLength + 1]  = {};
+        uint32_t first_index_[kMaxHuffmanCodeLength + 1] = {};
+        std::vector<uint16_t> sorted_;
+    };
+
+    //
+    // streams are laid out as count of symbols in 64 bits, code lengths and then the symbols, the
+    // last byte is padded with zero
+    //
+
+    // Huffman coding of bytes
+    template <typename TIter>
+    inline auto EncodeHuffman(TIter begin, TIter end)
+    {
+        static_assert(type::Constraint<TIter>(type::is_iterator_of<uint8_t>), "TIter must be an iterator type of uint8_t");
+
+        uint64_t freqs[256] = {};
+        uint64_t count      = 0;
+        for (auto p = begin; p != end; ++p, ++count)
+        {
+            freqs[static_cast<uint8_t>(*p)] += 1;
+        }
+
+        HuffmanEncoder encoder{BuildHuffmanLengths(freqs, 256)};
+
+        BitEmitter emit;
+        detail::WriteHuffmanCount(emit, count);
+        WriteHuffmanLengths(emit, encoder.Lengths());
+        for (auto p = begin; p != end; ++p)
+        {
+            encoder.Write(emit, static_cast<uint8_t>(*p));
+        }
+
+        return emit.Export();
+    }
+
+    template <typename TIter>
+    inline auto DecodeHuffman(TIter begin, TIter end)
+    {
+        BitReader<TIter> reader{begin, end};
+        auto count = detail::ReadHuffmanCount(reader);
+
+        HuffmanDecoder decoder{ReadHuffmanLengths(reader, 256)};
+        if (count > reader.RemainingSize())
+        {
+            throw 0; // not a valid huffman stream, every symbol takes at least one bit
+        }
+
+        std::vector<uint8_t> result(count);
+        decoder.Read(reader, result.data(), result.size());
+
+        return result;
+    }
+
+    namespace detail
+    {
+        // a dictionary code of LZW is Huffman coded by its high bits, followed by the low bits as
+        // is. usage of dictionary codes is close to uniform, so coding each of them as a symbol
+        // doesn't pay for its code length
+        static constexpr int kLzwHuffmanLowBits = 8;
+
+        // codes below first_code are symbols themselves, dictionary codes are mapped to symbols from
+        // first_code by their high bits
+        inline size_t GetLzwHuffmanAlphabetSize(uint32_t first_code) noexcept
+        {
+            return first_code + (kMaxCodeCount >> kLzwHuffmanLowBits) - 1;
+        }
+        inline uint32_t GetLzwHuffmanSymbol(uint32_t code, uint32_t first_code) noexcept
+        {
+            return code < first_code ? code : first_code + (code >> kLzwHuffmanLowBits) - 1;
+        }
+    } // namespace detail
+
+    // LZW followed by Huffman coding of its codes, instead of packing them in code width
+    //
+    // codes are packed as EncodeLzw does if it takes fewer bits, so the stream is never notably
+    // larger than that of EncodeLzw. a leading bit of the codes tells which way is taken
+    template <typename TPolicy = LzwNoReset, typename TIter>
+    inline auto EncodeLzwHuffman(TIter begin, TIter end, TPolicy policy = TPolicy{})
+    {
+        using namespace eds::compression::detail;
+
+        constexpr auto kFirstCode = GetFirstCode<TPolicy>();
+
+        std::vector<uint16_t> codes;
+        std::vector<uint8_t> widths;
+        size_t packed_bits = 0;
+
+        LzwCodeEncoder<TPolicy> lzw{std::move(policy)};
+        auto emit = [&](uint32_t code, int width) {
+            codes.push_back(static_cast<uint16_t>(code));
+            widths.push_back(static_cast<uint8_t>(width));
+            packed_bits += width;
+        };
+        lzw.Feed(begin, end, emit);
+        lzw.Finish(emit);
+
+        std::vector<uint64_t> freqs(GetLzwHuffmanAlphabetSize(kFirstCode));
+        for (auto code : codes)
+        {
+            freqs[GetLzwHuffmanSymbol(code, kFirstCode)] += 1;
+        }
+
+        HuffmanEncoder encoder{BuildHuffmanLengths(freqs.data(), freqs.size())};
+
+        BitEmitter lengths;
+        WriteHuffmanLengths(lengths, encoder.Lengths());
+
+        auto huffman_bits = lengths.Value().size() * 8;
+        for (size_t i = 0; i < freqs.size(); ++i)
+        {
+            auto low_bits = i < kFirstCode ? 0 : kLzwHuffmanLowBits;
+            huffman_bits += freqs[i] * (encoder.Lengths()[i] + low_bits);
+        }
+
+        BitEmitter bits;
+        WriteHuffmanCount(bits, codes.size());
+        if (huffman_bits < packed_bits)
+        {
+            bits.Write(1, 1);
+            WriteHuffmanLengths(bits, encoder.Lengths());
+            for (auto code : codes)
+            {
+                encoder.Write(bits, GetLzwHuffmanSymbol(code, kFirstCode));
+                if (code >= kFirstCode)
+                {
+                    bits.Write(code, kLzwHuffmanLowBits);
+                }
+            }
+        }
+        else
+        {
+            bits.Write(0, 1);
+            for (size_t i = 0; i < codes.size(); ++i)
+            {
+                bits.Write(codes[i], widths[i]);
+            }
+        }
+
+        return bits.Export();
+    }
+
+    // TPolicy must agree with the policy used to encode on kUseClearCode
+    template <typename TPolicy = LzwNoReset, typename TIter>
+    inline auto DecodeLzwHuffman(TIter begin, TIter end)
+    {
+        using namespace eds::compression::detail;
+
+        constexpr auto kFirstCode = GetFirstCode<TPolicy>();
+
+        BitReader<TIter> reader{begin, end};
+        auto count = ReadHuffmanCount(reader);
+        if (count >= reader.RemainingSize())
+        {
+            throw 0; // not a valid huffman stream, every code takes at least one bit
+        }
+
+        std::vector<uint8_t> result;
+        LzwCodeDecoder<TPolicy> lzw;
+        if (reader.Read(1) != 0)
+        {
+            HuffmanDecoder decoder{ReadHuffmanLengths(reader, GetLzwHuffmanAlphabetSize(kFirstCode))};
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                auto code = decoder.Read(reader);
+                if (code >= kFirstCode)
+                {
+                    if (reader.RemainingSize() < kLzwHuffmanLowBits)
+                    {
+                        throw 0; // huffman stream runs out
+                    }
+
+                    code = ((code - kFirstCode + 1) << kLzwHuffmanLowBits) | reader.Read(kLzwHuffmanLowBits);
+                }
+
+                lzw.Decode(code, result);
+            }
+        }
+        else
+        {
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                auto width = lzw.CodeWidth();
+                if (reader.RemainingSize() < static_cast<size_t>(width))
+                {
+                    throw 0; // lzw stream runs out
+                }
+
+                lzw.Decode(reader.Read(width), result);
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,373 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/compression/lzw.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// LZW frame format, input is split into chunks compressed independently, so that they could be
+// compressed and decompressed in parallel, and decompressed individually for random access
+//
+// all integers are little endian
+//
+//   header   magic u32, version u16, flags u16, chunk size u64, total size u64
+//   index    end offset u64 of each compressed chunk, relative to the start of chunk data
+//   chunks   compressed chunks back to back
+//
+// every chunk holds chunk size bytes of input except for the last one
+namespace eds::compression
+{
+    namespace detail
+    {
+        static constexpr uint32_t kLzwFrameMagic   = 0x465A4C45; // "ELZF" in little endian
+        static constexpr uint16_t kLzwFrameVersion = 1;
+
+        // set if chunks are encoded with a policy using kClearCode
+        static constexpr uint16_t kLzwFrameFlagClearCode = 1;
+
+        static constexpr size_t kLzwFrameHeaderSize = 24;
+
+        inline void StoreLittleEndian(std::vector<uint8_t>& output, uint64_t value, int size)
+        {
+            for (auto i = 0; i < size; ++i)
+            {
+                output.push_back(static_cast<uint8_t>(value >> (i * 8)));
+            }
+        }
+
+        inline uint64_t LoadLittleEndian(const uint8_t* p, int size) noexcept
+        {
+            uint64_t value = 0;
+            for (auto i = 0; i < size; ++i)
+            {
+                value |= static_cast<uint64_t>(p[i]) << (i * 8);
+            }
+
+            return value;
+        }
+
+        struct ThreadJoiner
+        {
+            std::vector<std::thread> threads;
+
+            ~ThreadJoiner()
+            {
+                Join();
+            }
+
+            void Join()
+            {
+                for (auto& t : threads)
+                {
+                    if (t.joinable())
+                    {
+                        t.join();
+                    }
+                }
+            }
+        };
+
+        // invoke fn(i) for i in [0, count) with up to thread_count threads including the calling one
+        // if a thread fails to start, work is done by those started
+        // the first exception thrown is rethrown once all threads finish
+        template <typename TFunc>
+        inline void ParallelFor(size_t count, unsigned thread_count, TFunc fn)
+        {
+            if (thread_count == 0)
+            {
+                thread_count = std::max(1U, std::thread::hardware_concurrency());
+            }
+            thread_count = static_cast<unsigned>(std::min<size_t>(thread_count, count));
+
+            if (thread_count <= 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    fn(i);
+                }
+
+                return;
+            }
+
+            std::atomic<size_t> next_index{0};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            auto worker = [&]() {
+                try
+                {
+                    for (auto i = next_index++; i < count; i = next_index++)
+                    {
+                        fn(i);
+                    }
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock{error_mutex};
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+
+                    // stop other threads from taking more work
+                    next_index = count;
+                }
+            };
+
+            // threads started are joined however this function exits
+            ThreadJoiner joiner;
+            joiner.threads.reserve(thread_count - 1);
+            for (unsigned i = 1; i < thread_count; ++i)
+            {
+                try
+                {
+                    joiner.threads.emplace_back(worker);
+                }
+                catch (const std::system_error&)
+                {
+                    // work is shared by threads already started and the calling one
+                    break;
+                }
+            }
+            worker();
+            joiner.Join();
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    } // namespace detail
+
+    struct LzwFrameOptions
+    {
+        // bytes of input in each chunk
+        size_t chunk_size = 1 << 20;
+
+        // 0 to use all hardware threads
+        unsigned thread_count = 0;
+    };
+
+    // compress data into the frame format, chunks are compressed in parallel
+    template <typename TPolicy = LzwNoReset>
+    inline std::vector<uint8_t> EncodeLzwFrame(const uint8_t* data, size_t size, const LzwFrameOptions& options = {})
+    {
+        using namespace eds::compression::detail;
+
+        assert(options.chunk_size > 0);
+
+        auto chunk_size  = options.chunk_size;
+        auto chunk_count = (size + chunk_size - 1) / chunk_size;
+
+        std::vector<std::vector<uint8_t>> chunks(chunk_count);
+        ParallelFor(chunk_count, options.thread_count, [&](size_t i) {
+            auto& output = chunks[i];
+            auto sink    = [&](const uint8_t* p, size_t n) { output.insert(output.end(), p, p + n); };
+
+            auto begin = data + i * chunk_size;
+            auto end   = data + std::min(size, (i + 1) * chunk_size);
+
+            LzwEncoder<decltype(sink), TPolicy> encoder{sink};
+            encoder.Feed(begin, end);
+            encoder.Finish();
+        });
+
+        std::vector<uint8_t> result;
+        StoreLittleEndian(result, kLzwFrameMagic, 4);
+        StoreLittleEndian(result, kLzwFrameVersion, 2);
+        StoreLittleEndian(result, TPolicy::kUseClearCode ? kLzwFrameFlagClearCode : 0, 2);
+        StoreLittleEndian(result, chunk_size, 8);
+        StoreLittleEndian(result, size, 8);
+
+        uint64_t offset = 0;
+        for (const auto& chunk : chunks)
+        {
+            offset += chunk.size();
+            StoreLittleEndian(result, offset, 8);
+        }
+
+        result.reserve(result.size() + offset);
+        for (const auto& chunk : chunks)
+        {
+            result.insert(result.end(), chunk.begin(), chunk.end());
+        }
+
+        return result;
+    }
+
+    // LzwFrameReader decompresses a frame in parallel or any range of it, decoding only chunks
+    // overlapping the range
+    //
+    // NOTE the reader refers to the frame, which must outlive it
+    class LzwFrameReader
+    {
+    public:
+        // parse the header and index, throws if data is not a valid frame
+        LzwFrameReader(const uint8_t* data, size_t size)
+        {
+            using namespace eds::compression::detail;
+
+            if (size < kLzwFrameHeaderSize ||
+                LoadLittleEndian(data, 4) != kLzwFrameMagic ||
+                LoadLittleEndian(data + 4, 2) != kLzwFrameVersion)
+            {
+                throw 0; // not a valid lzw frame
+            }
+
+            use_clear_code_ = (LoadLittleEndian(data + 6, 2) & kLzwFrameFlagClearCode) != 0;
+            chunk_size_     = LoadLittleEndian(data + 8, 8);
+            total_size_     = LoadLittleEndian(data + 16, 8);
+            if (chunk_size_ == 0)
+            {
+                throw 0; // not a valid lzw frame
+            }
+
+            chunk_count_ = total_size_ / chunk_size_ + (total_size_ % chunk_size_ != 0 ? 1 : 0);
+            if (chunk_count_ > (size - kLzwFrameHeaderSize) / 8)
+            {
+                throw 0; // not a valid lzw frame
+            }
+
+            index_       = data + kLzwFrameHeaderSize;
+            chunk_data_  = index_ + chunk_count_ * 8;
+            auto payload = static_cast<size_t>(data + size - chunk_data_);
+
+            uint64_t last_offset = 0;
+            for (size_t i = 0; i < chunk_count_; ++i)
+            {
+                auto offset = LoadLittleEndian(index_ + i * 8, 8);
+                if (offset < last_offset || offset > payload)
+                {
+                    throw 0; // not a valid lzw frame
+                }
+
+                last_offset = offset;
+            }
+        }
+
+        // bytes of data decompressed
+        size_t Size() const noexcept
+        {
+            return total_size_;
+        }
+
+        size_t ChunkSize() const noexcept
+        {
+            return chunk_size_;
+        }
+
+        size_t ChunkCount() const noexcept
+        {
+            return chunk_count_;
+        }
+
+        // decompress [offset, offset + size) of data into dest, chunks are decompressed in parallel
+        void Read(size_t offset, size_t size, uint8_t* dest, unsigned thread_count = 0) const
+        {
+            assert(offset <= total_size_ && size <= total_size_ - offset);
+
+            if (size == 0)
+            {
+                return;
+            }
+
+            auto first_chunk = offset / chunk_size_;
+            auto last_chunk  = (offset + size - 1) / chunk_size_;
+            detail::ParallelFor(last_chunk - first_chunk + 1, thread_count, [&](size_t i) {
+                auto chunk_begin = (first_chunk + i) * chunk_size_;
+                auto begin       = std::max(offset, chunk_begin);
+                auto end         = std::min(offset + size, chunk_begin + chunk_size_);
+
+                DecodeChunk(first_chunk + i, begin - chunk_begin, end - chunk_begin, dest + (begin - offset));
+            });
+        }
+
+        std::vector<uint8_t> ReadAll(unsigned thread_count = 0) const
+        {
+            std::vector<uint8_t> result(total_size_);
+            Read(0, total_size_, result.data(), thread_count);
+
+            return result;
+        }
+
+    private:
+        // decompress chunk i and copy its bytes in [begin, end) to dest
+        void DecodeChunk(size_t i, size_t begin, size_t end, uint8_t* dest) const
+        {
+            if (use_clear_code_)
+            {
+                DecodeChunkWith<LzwResetOnFull>(i, begin, end, dest);
+            }
+            else
+            {
+                DecodeChunkWith<LzwNoReset>(i, begin, end, dest);
+            }
+        }
+
+        template <typename TPolicy>
+        void DecodeChunkWith(size_t i, size_t begin, size_t end, uint8_t* dest) const
+        {
+            using detail::LoadLittleEndian;
+
+            auto expected = std::min(chunk_size_, total_size_ - i * chunk_size_);
+
+            // bytes of the chunk decoded so far
+            size_t decoded = 0;
+            auto sink      = [&](const uint8_t* p, size_t n) {
+                if (n > expected - decoded)
+                {
+                    throw 0; // chunk is longer than expected
+                }
+
+                // copy part of [decoded, decoded + n) that overlaps [begin, end)
+                auto copy_begin = std::max(begin, decoded);
+                auto copy_end   = std::min(end, decoded + n);
+                if (copy_begin < copy_end)
+                {
+                    std::memcpy(dest + (copy_begin - begin), p + (copy_begin - decoded), copy_end - copy_begin);
+                }
+
+                decoded += n;
+            };
+
+            auto chunk_begin = i == 0 ? 0 : LoadLittleEndian(index_ + (i - 1) * 8, 8);
+            auto chunk_end   = LoadLittleEndian(index_ + i * 8, 8);
+
+            LzwDecoder<decltype(sink), TPolicy> decoder{sink};
+            decoder.Feed(chunk_data_ + chunk_begin, chunk_data_ + chunk_end);
+            decoder.Finish();
+
+            if (decoded != expected)
+            {
+                throw 0; // chunk is shorter than expected
+            }
+        }
+
+        bool use_clear_code_;
+        uint64_t chunk_size_;
+        uint64_t total_size_;
+        size_t chunk_count_;
+
+        const uint8_t* index_;
+        const uint8_t* chunk_data_;
+    };
+
+    // decompress a whole frame, chunks are decompressed in parallel
+    inline std::vector<uint8_t> DecodeLzwFrame(const uint8_t* data, size_t size, unsigned thread_count = 0)
+    {
+        return LzwFrameReader{data, size}.ReadAll(thread_count);
+    }
+}
@@ -1,11 +1,16 @@
 #pragma once
-#include "../memory/arena.h"
+#include "../lang-utils.h"
 #include "../binary/bit-ops.h"
 #include "../type-utils.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 // LWZ implementation
-// ASSUMES MSB-first behavior
+// codes are packed in the bit order of TOrder, MsbFirst as compress(1) by default or LsbFirst as GIF
 namespace eds::compression
 {
     namespace detail
@@ -14,152 +19,474 @@ namespace eds::compression
         static constexpr int kMaxCodeWidth             = 16;
         static constexpr int kCodeWidthIncrementalStep = 1;
 
-        struct LzwTrieNode
+        static constexpr uint32_t kMaxCodeCount = 1U << kMaxCodeWidth;
+        static constexpr uint32_t kInvalidCode  = ~0U;
+
+        // reserved to reset the dictionary in streams encoded with a reset policy
+        static constexpr uint32_t kClearCode = 256;
+
+        template <typename TPolicy>
+        constexpr uint32_t GetFirstCode() noexcept
         {
-            uint32_t code;
-            int length;
+            return TPolicy::kUseClearCode ? kClearCode + 1 : 256;
+        }
+
+        // code assignment and code width, shared by encoder and decoder so that they grow in lockstep
+        // codes of single bytes are implicit, i.e. code of byte b is b
+        class LzwCodeSpace
+        {
+        public:
+            explicit LzwCodeSpace(uint32_t first_code) noexcept
+                : first_code_(first_code)
+            {
+                ResetCodes();
+            }
+
+            int CodeWidth() const noexcept { return code_width_; }
+            uint32_t NextCode() const noexcept { return next_code_; }
+            bool AllowGrowth() const noexcept { return next_code_ < kMaxCodeCount; }
+
+            void ReserveWidth() noexcept
+            {
+                if (next_code_ >= (1U << code_width_) && AllowGrowth())
+                {
+                    code_width_ += kCodeWidthIncrementalStep;
+                }
+            }
+
+        protected:
+            // forget all assigned codes
+            void ResetCodes() noexcept
+            {
+                next_code_  = first_code_;
+                code_width_ = kMinCodeWidth;
+
+                // codes below the first one, including kClearCode, must be representable
+                while ((1U << code_width_) < first_code_)
+                {
+                    code_width_ += kCodeWidthIncrementalStep;
+                }
+            }
 
-            uint8_t value;
-            LzwTrieNode* parent;
-            LzwTrieNode* children[256];
+            uint32_t first_code_;
+            uint32_t next_code_;
+            int code_width_;
         };
 
-        class LzwDictionary
+        // dictionary of the encoder, an open-addressing table that maps (prefix code, byte) to the
+        // code of the extended sequence
+        //
+        // a slot takes 8 bytes and load factor is kept no more than 1/2, so a full dictionary
+        // takes 1MB while a small input stays within the initial 8KB table
+        class LzwEncodeDictionary : public LzwCodeSpace
         {
         public:
-            LzwDictionary()
+            static constexpr size_t kInitialSlotCount = 1024;
+
+            explicit LzwEncodeDictionary(uint32_t first_code)
+                : LzwCodeSpace(first_code), slots_(kInitialSlotCount, Slot{kEmptyKey, kInvalidCode}), shift_(32 - 10) {}
+
+            // returns kInvalidCode if prefix followed by b is not in the dictionary
+            uint32_t Find(uint32_t prefix, uint8_t b) const noexcept
+            {
+                auto key  = MakeKey(prefix, b);
+                auto mask = slots_.size() - 1;
+                for (auto index = GetSlotIndex(key);; index = (index + 1) & mask)
+                {
+                    const auto& slot = slots_[index];
+                    if (slot.key == key || slot.key == kEmptyKey)
+                    {
+                        return slot.code;
+                    }
+                }
+            }
+
+            // assign the next code to prefix followed by b, which must not be in the dictionary
+            void Insert(uint32_t prefix, uint8_t b)
             {
-                for (auto i = 0; i < 256; ++i)
+                // keep load factor no more than 1/2
+                if ((next_code_ - first_code_ + 1) * 2 > slots_.size())
                 {
-                    root_nodes_[i] = NewNode(nullptr, i);
+                    Grow();
                 }
+
+                Place(Slot{MakeKey(prefix, b), next_code_++});
             }
 
-            int CodeWidth() { return code_width_; }
-            bool AllowGrowth() { return next_code_ < (1 << kMaxCodeWidth); }
+            // forget all sequences, the table is kept at its current size
+            void Reset() noexcept
+            {
+                ResetCodes();
+                std::fill(slots_.begin(), slots_.end(), Slot{kEmptyKey, kInvalidCode});
+            }
+
+        private:
+            struct Slot
+            {
+                // kEmptyKey if the slot is empty
+                uint32_t key;
+                uint32_t code;
+            };
+
+            // prefix is less than 2^16, so no key collides with kEmptyKey
+            static constexpr uint32_t kEmptyKey = ~0U;
 
-            LzwTrieNode* LookupRoot(uint8_t b)
+            static uint32_t MakeKey(uint32_t prefix, uint8_t b) noexcept
             {
-                return root_nodes_[b];
+                return (prefix << 8) | b;
             }
 
-            void ReserveWidth()
+            // fibonacci hashing
+            size_t GetSlotIndex(uint32_t key) const noexcept
             {
-                if (next_code_ >= (1U << code_width_) && AllowGrowth())
+                return static_cast<uint32_t>(key * 0x9E3779B1U) >> shift_;
+            }
+
+            void Place(Slot slot) noexcept
+            {
+                auto mask  = slots_.size() - 1;
+                auto index = GetSlotIndex(slot.key);
+                while (slots_[index].key != kEmptyKey)
                 {
-                    code_width_ += kCodeWidthIncrementalStep;
+                    index = (index + 1) & mask;
                 }
+
+                slots_[index] = slot;
             }
 
-            LzwTrieNode* UpdateNode(LzwTrieNode* prefix, uint8_t b)
+            void Grow()
             {
-                return (prefix->children[b] = NewNode(prefix, b));
+                std::vector<Slot> old_slots(slots_.size() * 2, Slot{kEmptyKey, kInvalidCode});
+                old_slots.swap(slots_);
+                shift_ -= 1;
+
+                for (const auto& slot : old_slots)
+                {
+                    if (slot.key != kEmptyKey)
+                    {
+                        Place(slot);
+                    }
+                }
             }
 
-        private:
-            LzwTrieNode* NewNode(LzwTrieNode* prefix, uint8_t value)
+            std::vector<Slot> slots_;
+            int shift_;
+        };
+
+        // dictionary of the decoder, sequences are stored as flat arrays indexed by code
+        class LzwDecodeDictionary : public LzwCodeSpace
+        {
+        public:
+            explicit LzwDecodeDictionary(uint32_t first_code)
+                : LzwCodeSpace(first_code)
             {
-                auto node    = arena_.Construct<LzwTrieNode>();
-                node->code   = next_code_++;
-                node->length = prefix == nullptr ? 1 : prefix->length + 1;
-                node->value  = value;
-                node->parent = prefix;
-                std::fill_n(&node->children[0], 256, nullptr);
+                entries_.reserve(1024);
+                for (uint32_t i = 0; i < first_code; ++i)
+                {
+                    // entry of kClearCode is never expanded
+                    entries_.push_back(Entry{kInvalidCode, 1, static_cast<uint8_t>(i)});
+                }
+            }
 
-                return node;
+            bool Contains(uint32_t code) const noexcept
+            {
+                return code < next_code_;
             }
 
-            Arena arena_;
-            LzwTrieNode* root_nodes_[256];
+            // assign the next code to prefix followed by b
+            void Insert(uint32_t prefix, uint8_t b)
+            {
+                entries_.push_back(Entry{prefix, entries_[prefix].length + 1, b});
+                next_code_ += 1;
+            }
+
+            // forget all sequences
+            void Reset() noexcept
+            {
+                ResetCodes();
+                entries_.resize(first_code_);
+            }
+
+            // appends the sequence of code to output
+            void Expand(std::vector<uint8_t>& output, uint32_t code) const
+            {
+                output.resize(output.size() + entries_[code].length);
+
+                auto it = output.rbegin();
+                for (auto p = code; p != kInvalidCode; p = entries_[p].prefix)
+                {
+                    *it = entries_[p].value;
+                    ++it;
+                }
+            }
 
-            int code_width_     = kMinCodeWidth;
-            uint32_t next_code_ = 0;
+        private:
+            struct Entry
+            {
+                // kInvalidCode for single bytes
+                uint32_t prefix;
+                uint32_t length;
+                uint8_t value;
+            };
+
+            std::vector<Entry> entries_;
         };
+    } // namespace detail
 
-        // expands node into the sequence it encodes
-        inline void ExpandDecodedSeq(std::vector<uint8_t>& output, LzwTrieNode* node)
+    //
+    // reset policies decide when the encoder clears the dictionary, a policy provides:
+    //
+    //   kUseClearCode: if kClearCode is reserved in the stream, the decoder must use a policy that agrees
+    //   ShouldReset(full, byte_consumed, bit_emitted): queried after each code with running totals of
+    //                                                  the stream, the dictionary is reset if it returns true
+    //
+
+    // never reset, the dictionary stops growing once it's full
+    // this is the default and its stream has no kClearCode
+    struct LzwNoReset
+    {
+        static constexpr bool kUseClearCode = false;
+
+        bool ShouldReset(bool, size_t, size_t) noexcept
+        {
+            return false;
+        }
+    };
+
+    // reset as soon as the dictionary is full
+    struct LzwResetOnFull
+    {
+        static constexpr bool kUseClearCode = true;
+
+        bool ShouldReset(bool full, size_t, size_t) noexcept
         {
-            output.resize(output.size() + node->length);
+            return full;
+        }
+    };
+
+    // once the dictionary is full, measure compression ratio every kCheckInterval input bytes and
+    // reset when it falls notably below the best seen since, as compress(1) does
+    class LzwAdaptiveReset
+    {
+    public:
+        static constexpr bool kUseClearCode = true;
 
-            auto it = output.rbegin();
-            auto p  = node;
-            while (p)
+        static constexpr size_t kCheckInterval = 16384;
+
+        bool ShouldReset(bool full, size_t byte_consumed, size_t bit_emitted) noexcept
+        {
+            if (!full)
             {
-                *it = p->value;
+                checking_ = false;
+                return false;
+            }
 
-                p = p->parent;
-                ++it;
+            if (!checking_)
+            {
+                StartWindow(byte_consumed, bit_emitted);
+                best_ratio_ = 0;
+                checking_   = true;
+                return false;
+            }
+
+            if (byte_consumed - window_byte_ < kCheckInterval)
+            {
+                return false;
+            }
+
+            // ratio of the last window only, so that it follows drift in the data
+            auto ratio = static_cast<double>(byte_consumed - window_byte_) * 8 / (bit_emitted - window_bit_);
+            StartWindow(byte_consumed, bit_emitted);
+
+            best_ratio_ = std::max(best_ratio_, ratio);
+            if (ratio < best_ratio_ * 0.9)
+            {
+                checking_ = false;
+                return true;
             }
+
+            return false;
         }
-    } // namespace detail
 
-    template <typename TIter>
-    inline auto EncodeLzw(TIter begin, TIter end)
+    private:
+        void StartWindow(size_t byte_consumed, size_t bit_emitted) noexcept
+        {
+            window_byte_ = byte_consumed;
+            window_bit_  = bit_emitted;
+        }
+
+        bool checking_      = false;
+        double best_ratio_  = 0;
+        size_t window_byte_ = 0;
+        size_t window_bit_  = 0;
+    };
+
+    static constexpr size_t kDefaultLzwChunkSize = 64 * 1024;
+
+    // LzwCodeEncoder matches input against the dictionary and produces codes, without packing them
+    // codes are passed to emit, a callable of void(uint32_t code, int width), where width is the
+    // code width of the dictionary when the code is produced
+    //
+    // LzwEncoder packs codes into bits, other coders could take codes instead, e.g. Huffman coding
+    template <typename TPolicy = LzwNoReset>
+    class LzwCodeEncoder
     {
-        static_assert(type::Constraint<TIter>(type::is_iterator_of<uint8_t>), "TIter must be an iterator type of uint8_t");
+    public:
+        explicit LzwCodeEncoder(TPolicy policy = TPolicy{})
+            : policy_(std::move(policy)), dict_(detail::GetFirstCode<TPolicy>()) {}
+
+        EDSLIB_DISABLE_COPYMOVE(LzwCodeEncoder)
 
-        using namespace std;
-        using namespace eds::compression::detail;
+        template <typename TIter, typename TEmit>
+        void Feed(TIter begin, TIter end, TEmit&& emit)
+        {
+            static_assert(type::Constraint<TIter>(type::is_iterator_of<uint8_t>), "TIter must be an iterator type of uint8_t");
 
-        LzwDictionary dict;
-        BitEmitter emit;
+            using detail::kInvalidCode;
 
-        for (auto p = begin; p != end;)
+            auto code          = code_;
+            auto byte_consumed = byte_consumed_;
+            for (auto p = begin; p != end; ++p, ++byte_consumed)
+            {
+                uint8_t b = *p;
+                if (code != kInvalidCode)
+                {
+                    // extend the current sequence if possible
+                    auto next = dict_.Find(code, b);
+                    if (next != kInvalidCode)
+                    {
+                        code = next;
+                        continue;
+                    }
+
+                    Emit(code, emit);
+                    Grow(code, b, byte_consumed, emit);
+                }
+                else if (pending_code_ != kInvalidCode)
+                {
+                    Grow(pending_code_, b, byte_consumed, emit);
+                    pending_code_ = kInvalidCode;
+                }
+
+                code = b;
+            }
+
+            code_          = code;
+            byte_consumed_ = byte_consumed;
+        }
+
+        // end the current sequence early
+        template <typename TEmit>
+        void Flush(TEmit&& emit)
+        {
+            if (code_ != detail::kInvalidCode)
+            {
+                Emit(code_, emit);
+                pending_code_ = code_;
+                code_         = detail::kInvalidCode;
+            }
+        }
+
+        // end the stream, the encoder is ready for a new stream afterwards
+        template <typename TEmit>
+        void Finish(TEmit&& emit)
+        {
+            if (code_ != detail::kInvalidCode)
+            {
+                Emit(code_, emit);
+            }
+
+            dict_.Reset();
+            code_          = detail::kInvalidCode;
+            pending_code_  = detail::kInvalidCode;
+            byte_consumed_ = 0;
+            bit_emitted_   = 0;
+        }
+
+    private:
+        template <typename TEmit>
+        void Emit(uint32_t code, TEmit& emit)
         {
-            auto node = dict.LookupRoot(*p);
-            ++p;
+            emit(code, dict_.CodeWidth());
+            bit_emitted_ += dict_.CodeWidth();
+        }
 
-            while (p != end && node->children[*p] != nullptr)
+        // add code followed by b to the dictionary, b is the first byte after code is emitted
+        template <typename TEmit>
+        void Grow(uint32_t code, uint8_t b, size_t byte_consumed, TEmit& emit)
+        {
+            if (dict_.AllowGrowth())
             {
-                node = node->children[*p];
-                ++p;
+                dict_.ReserveWidth();
+                dict_.Insert(code, b);
             }
 
-            emit.Write(node->code, dict.CodeWidth());
-            if (p != end && dict.AllowGrowth())
+            if constexpr (TPolicy::kUseClearCode)
             {
-                dict.ReserveWidth();
-                dict.UpdateNode(node, *p);
+                // kClearCode takes place of the next code, so it's written in the same width
+                if (policy_.ShouldReset(!dict_.AllowGrowth(), byte_consumed, bit_emitted_))
+                {
+                    Emit(detail::kClearCode, emit);
+                    dict_.Reset();
+                }
             }
         }
 
-        return emit.Export();
-    }
+        TPolicy policy_;
+        detail::LzwEncodeDictionary dict_;
 
-    template <typename TIter>
-    inline auto DecodeLzw(TIter begin, TIter end)
+        // code of the sequence being matched
+        uint32_t code_ = detail::kInvalidCode;
+        // code emitted by Flush, which is added to the dictionary with the next byte
+        uint32_t pending_code_ = detail::kInvalidCode;
+
+        // running totals for the policy, bits are counted in code width
+        size_t byte_consumed_ = 0;
+        size_t bit_emitted_   = 0;
+    };
+
+    // LzwCodeDecoder expands codes produced by LzwCodeEncoder
+    // TPolicy must agree with the policy used to encode on kUseClearCode
+    template <typename TPolicy = LzwNoReset>
+    class LzwCodeDecoder
     {
-        static_assert(type::Constraint<TIter>(type::is_iterator_of<uint8_t>), "TIter must be an iterator type of uint8_t");
+    public:
+        LzwCodeDecoder()
+            : dict_(detail::GetFirstCode<TPolicy>()) {}
 
-        using namespace std;
-        using namespace eds::compression::detail;
+        EDSLIB_DISABLE_COPYMOVE(LzwCodeDecoder)
 
-        LzwDictionary dict;
-        std::vector<LzwTrieNode*> code_lookup;
-        for (auto i = 0; i < 256; ++i)
+        // width of the next code
+        int CodeWidth() const noexcept
         {
-            code_lookup.push_back(dict.LookupRoot(i));
+            return dict_.CodeWidth();
         }
 
-        BitReader<TIter> reader{begin, end};
-        vector<uint8_t> result;
-        LzwTrieNode* last_seq_tail = nullptr;
-        while (reader.RemainingSize() >= dict.CodeWidth())
+        // append the sequence of code to output
+        void Decode(uint32_t code, std::vector<uint8_t>& output)
         {
-            // load next code
-            auto code = reader.Read(dict.CodeWidth());
+            using detail::kInvalidCode;
+
+            if constexpr (TPolicy::kUseClearCode)
+            {
+                if (code == detail::kClearCode)
+                {
+                    dict_.Reset();
+                    last_code_ = kInvalidCode;
+                    return;
+                }
+            }
 
-            // append decoded data to result
-            // after expansion, result[old_size] would be the first element of the sequence generated
-            auto old_size = result.size();
-            if (code < code_lookup.size())
+            // after expansion, output[old_size] would be the first element of the sequence generated
+            auto old_size = output.size();
+            if (dict_.Contains(code))
             {
-                ExpandDecodedSeq(result, code_lookup[code]);
+                dict_.Expand(output, code);
             }
-            else if (last_seq_tail && code == code_lookup.size())
+            else if (last_code_ != kInvalidCode && code == dict_.NextCode() && dict_.AllowGrowth())
             {
-                ExpandDecodedSeq(result, last_seq_tail);
-                result.push_back(result[old_size]);
+                dict_.Expand(output, last_code_);
+                output.push_back(output[old_size]);
             }
             else
             {
@@ -167,16 +494,232 @@ namespace eds::compression
             }
 
             // update dictionary
-            if (last_seq_tail && dict.AllowGrowth())
+            if (last_code_ != kInvalidCode && dict_.AllowGrowth())
+            {
+                dict_.Insert(last_code_, output[old_size]);
+            }
+            dict_.ReserveWidth();
+
+            last_code_ = code;
+        }
+
+        // the decoder is ready for a new stream afterwards
+        void Reset()
+        {
+            dict_.Reset();
+            last_code_ = detail::kInvalidCode;
+        }
+
+    private:
+        detail::LzwDecodeDictionary dict_;
+        uint32_t last_code_ = detail::kInvalidCode;
+    };
+
+    // LzwEncoder compresses a stream fed piece by piece, the dictionary is kept across calls
+    //
+    // compressed data is sent to sink, a callable of void(const uint8_t* data, size_t size), in
+    // chunks of chunk_size bytes, except by Flush and Finish. memory taken is bounded by the
+    // dictionary and one chunk regardless of the length of the stream
+    template <typename TSink, typename TPolicy = LzwNoReset, typename TOrder = MsbFirst>
+    class LzwEncoder
+    {
+    public:
+        explicit LzwEncoder(TSink sink, size_t chunk_size = kDefaultLzwChunkSize, TPolicy policy = TPolicy{})
+            : sink_(std::move(sink)), chunk_size_(chunk_size), encoder_(std::move(policy))
+        {
+            assert(chunk_size > 0);
+        }
+
+        EDSLIB_DISABLE_COPYMOVE(LzwEncoder)
+
+        template <typename TIter>
+        void Feed(TIter begin, TIter end)
+        {
+            encoder_.Feed(begin, end, [this](uint32_t code, int width) { Emit(code, width); });
+        }
+        void Feed(const uint8_t* data, size_t size)
+        {
+            Feed(data, data + size);
+        }
+
+        // end the current sequence early and send all complete bytes to sink
+        // NOTE the stream isn't byte aligned, so up to 7 bits of the last code are held until more
+        //      codes are written, the decoder could lag behind by that code
+        void Flush()
+        {
+            encoder_.Flush([this](uint32_t code, int width) { Emit(code, width); });
+            emit_.Drain(SendChunks(emit_.CompleteSize(), true));
+        }
+
+        // end the stream and send everything to sink, the encoder is ready for a new stream afterwards
+        void Finish()
+        {
+            encoder_.Finish([this](uint32_t code, int width) { Emit(code, width); });
+
+            // the last byte is padded with zero
+            SendChunks(emit_.Value().size(), true);
+            emit_.Reset();
+        }
+
+    private:
+        void Emit(uint32_t code, int width)
+        {
+            emit_.Write(code, width);
+
+            if (emit_.CompleteSize() >= chunk_size_)
+            {
+                emit_.Drain(SendChunks(emit_.CompleteSize(), false));
+            }
+        }
+
+        // send first n bytes emitted in full chunks, and the remainder as well if partial is set
+        // returns count of bytes sent
+        size_t SendChunks(size_t n, bool partial)
+        {
+            auto data = emit_.Value().data();
+
+            size_t sent = 0;
+            while (n - sent >= chunk_size_)
+            {
+                sink_(data + sent, chunk_size_);
+                sent += chunk_size_;
+            }
+            if (partial && sent < n)
+            {
+                sink_(data + sent, n - sent);
+                sent = n;
+            }
+
+            return sent;
+        }
+
+        TSink sink_;
+        size_t chunk_size_;
+
+        LzwCodeEncoder<TPolicy> encoder_;
+        BasicBitEmitter<TOrder> emit_;
+    };
+
+    // LzwDecoder decompresses a stream fed piece by piece, see LzwEncoder
+    // TPolicy must agree with the policy used to encode on kUseClearCode, and TOrder must be the same
+    template <typename TSink, typename TPolicy = LzwNoReset, typename TOrder = MsbFirst>
+    class LzwDecoder
+    {
+    public:
+        explicit LzwDecoder(TSink sink, size_t chunk_size = kDefaultLzwChunkSize)
+            : sink_(std::move(sink)), chunk_size_(chunk_size)
+        {
+            assert(chunk_size > 0);
+        }
+
+        EDSLIB_DISABLE_COPYMOVE(LzwDecoder)
+
+        template <typename TIter>
+        void Feed(TIter begin, TIter end)
+        {
+            static_assert(type::Constraint<TIter>(type::is_iterator_of<uint8_t>), "TIter must be an iterator type of uint8_t");
+
+            for (auto p = begin; p != end; ++p)
             {
-                auto new_node = dict.UpdateNode(last_seq_tail, result[old_size]);
-                code_lookup.push_back(new_node);
+                // bit_count_ is less than code width here, so the buffer never overflows
+                bits_ |= TOrder::PlaceByte(static_cast<uint8_t>(*p), bit_count_);
+                bit_count_ += 8;
+
+                while (bit_count_ >= decoder_.CodeWidth())
+                {
+                    auto width = decoder_.CodeWidth();
+                    auto code  = TOrder::Front(bits_, width);
+                    bits_      = TOrder::Advance(bits_, width);
+                    bit_count_ -= width;
+
+                    decoder_.Decode(code, output_);
+                    if (output_.size() >= chunk_size_)
+                    {
+                        SendChunks(false);
+                    }
+                }
             }
-            dict.ReserveWidth();
+        }
+        void Feed(const uint8_t* data, size_t size)
+        {
+            Feed(data, data + size);
+        }
 
-            last_seq_tail = code_lookup[code];
+        // send all decoded bytes to sink
+        void Flush()
+        {
+            SendChunks(true);
         }
 
+        // end the stream and send everything to sink, the decoder is ready for a new stream afterwards
+        // bits left are padding of the last byte
+        void Finish()
+        {
+            SendChunks(true);
+
+            decoder_.Reset();
+            bits_      = 0;
+            bit_count_ = 0;
+        }
+
+    private:
+        // send decoded bytes in full chunks, and the remainder as well if partial is set
+        void SendChunks(bool partial)
+        {
+            auto n = output_.size();
+
+            size_t sent = 0;
+            while (n - sent >= chunk_size_)
+            {
+                sink_(output_.data() + sent, chunk_size_);
+                sent += chunk_size_;
+            }
+            if (partial && sent < n)
+            {
+                sink_(output_.data() + sent, n - sent);
+                sent = n;
+            }
+
+            output_.erase(output_.begin(), output_.begin() + sent);
+        }
+
+        TSink sink_;
+        size_t chunk_size_;
+
+        LzwCodeDecoder<TPolicy> decoder_;
+
+        // bits fed but not yet decoded, laid out as the buffer of BitReader
+        uint64_t bits_ = 0;
+        int bit_count_ = 0;
+
+        // decoded bytes not yet sent
+        std::vector<uint8_t> output_;
+    };
+
+    template <typename TPolicy = LzwNoReset, typename TOrder = MsbFirst, typename TIter>
+    inline auto EncodeLzw(TIter begin, TIter end, TPolicy policy = TPolicy{})
+    {
+        std::vector<uint8_t> result;
+
+        auto sink = [&](const uint8_t* data, size_t size) { result.insert(result.end(), data, data + size); };
+        LzwEncoder<decltype(sink), TPolicy, TOrder> encoder{sink, kDefaultLzwChunkSize, std::move(policy)};
+        encoder.Feed(begin, end);
+        encoder.Finish();
+
+        return result;
+    }
+
+    // TPolicy must agree with the policy used to encode on kUseClearCode, and TOrder must be the same
+    template <typename TPolicy = LzwNoReset, typename TOrder = MsbFirst, typename TIter>
+    inline auto DecodeLzw(TIter begin, TIter end)
+    {
+        std::vector<uint8_t> result;
+
+        auto sink = [&](const uint8_t* data, size_t size) { result.insert(result.end(), data, data + size); };
+        LzwDecoder<decltype(sink), TPolicy, TOrder> decoder{sink};
+        decoder.Feed(begin, end);
+        decoder.Finish();
+
         return result;
     }
 }
\ No newline at end of file
@@ -0,0 +1,403 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/memory/arena.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace eds
+{
+    // ArenaHashMap is a chained hash map whose nodes and bucket arrays are allocated from an arena
+    //
+    // nodes are also linked in insertion order, which is the order of iteration. as nodes are mostly
+    // allocated one after another from the arena, iteration walks memory almost sequentially.
+    // bucket arrays are abandoned in the arena when the map regrows and erased nodes are reused
+    //
+    // NOTE the arena must not be cleared or rewound past the map before it's destroyed
+    template <typename Key,
+              typename Value,
+              typename Hash     = std::hash<Key>,
+              typename KeyEqual = std::equal_to<Key>,
+              typename TArena   = Arena>
+    class ArenaHashMap
+    {
+    public:
+        using key_type        = Key;
+        using mapped_type     = Value;
+        using value_type      = std::pair<const Key, Value>;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher          = Hash;
+        using key_equal       = KeyEqual;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+
+    private:
+        struct Node
+        {
+            // next node in the same bucket, or in the free list
+            Node* chain;
+            // neighbours in insertion order
+            Node* prev;
+            Node* next;
+
+            size_t hash;
+            value_type value;
+        };
+
+        template <bool IsConst>
+        class Iterator
+        {
+            friend class ArenaHashMap;
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = typename ArenaHashMap::value_type;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = std::conditional_t<IsConst, const value_type*, value_type*>;
+            using reference         = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+            Iterator() = default;
+            Iterator(const ArenaHashMap* owner, Node* node) noexcept
+                : owner_(owner), node_(node) {}
+
+            operator Iterator<true>() const noexcept
+            {
+                return Iterator<true>{owner_, node_};
+            }
+
+            reference operator*() const noexcept { return node_->value; }
+            pointer operator->() const noexcept { return &node_->value; }
+
+            Iterator& operator++() noexcept
+            {
+                node_ = node_->next;
+                return *this;
+            }
+            Iterator operator++(int) noexcept
+            {
+                auto result = *this;
+                node_       = node_->next;
+                return result;
+            }
+            Iterator& operator--() noexcept
+            {
+                node_ = node_ != nullptr ? node_->prev : owner_->last_;
+                return *this;
+            }
+            Iterator operator--(int) noexcept
+            {
+                auto result = *this;
+                --*this;
+                return result;
+            }
+
+            bool operator==(const Iterator& other) const noexcept { return node_ == other.node_; }
+            bool operator!=(const Iterator& other) const noexcept { return node_ != other.node_; }
+
+        private:
+            const ArenaHashMap* owner_ = nullptr;
+            Node* node_                = nullptr;
+        };
+
+    public:
+        using iterator       = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        static constexpr size_t kInitialBucketCount = 16;
+
+        explicit ArenaHashMap(TArena& arena, const Hash& hash = Hash{}, const KeyEqual& equal = KeyEqual{})
+            : arena_(&arena), hash_(hash), equal_(equal) {}
+
+        EDSLIB_DISABLE_COPYMOVE(ArenaHashMap)
+
+        ~ArenaHashMap()
+        {
+            clear();
+        }
+
+        //
+        // iterator
+        //
+        iterator begin() noexcept { return iterator{this, first_}; }
+        iterator end() noexcept { return iterator{this, nullptr}; }
+        const_iterator begin() const noexcept { return const_iterator{this, first_}; }
+        const_iterator end() const noexcept { return const_iterator{this, nullptr}; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        //
+        // capacity
+        //
+        bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+        size_type size() const noexcept
+        {
+            return size_;
+        }
+        size_type bucket_count() const noexcept
+        {
+            return bucket_count_;
+        }
+
+        // prepare buckets so that n elements could be inserted without regrowing
+        void reserve(size_type n)
+        {
+            if (n > bucket_count_)
+            {
+                Rehash(n);
+            }
+        }
+
+        //
+        // lookup
+        //
+        iterator find(const Key& key) noexcept
+        {
+            return iterator{this, FindNode(key, hash_(key))};
+        }
+        const_iterator find(const Key& key) const noexcept
+        {
+            return const_iterator{this, FindNode(key, hash_(key))};
+        }
+        size_type count(const Key& key) const noexcept
+        {
+            return FindNode(key, hash_(key)) != nullptr ? 1 : 0;
+        }
+
+        Value& operator[](const Key& key)
+        {
+            return try_emplace(key).first->second;
+        }
+        Value& operator[](Key&& key)
+        {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        //
+        // modifiers
+        //
+
+        // construct the value from args if key is not present, nothing is constructed otherwise
+        template <typename K, typename... TArgs>
+        std::pair<iterator, bool> try_emplace(K&& key, TArgs&&... args)
+        {
+            auto hash = hash_(key);
+            if (auto node = FindNode(key, hash); node != nullptr)
+            {
+                return {iterator{this, node}, false};
+            }
+
+            auto node = AcquireNode();
+            try
+            {
+                new (&node->value) value_type(std::piecewise_construct,
+                                              std::forward_as_tuple(std::forward<K>(key)),
+                                              std::forward_as_tuple(std::forward<TArgs>(args)...));
+            }
+            catch (...)
+            {
+                ReleaseNode(node);
+                throw;
+            }
+
+            node->hash = hash;
+            LinkNode(node);
+            return {iterator{this, node}, true};
+        }
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+        std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return try_emplace(value.first, std::move(value.second));
+        }
+
+        // destroy the element at pos, returns the iterator following it
+        iterator erase(const_iterator pos) noexcept
+        {
+            assert(pos != end());
+
+            auto node = pos.node_;
+            auto next = node->next;
+
+            UnlinkNode(node);
+            node->value.~value_type();
+            ReleaseNode(node);
+
+            return iterator{this, next};
+        }
+        size_type erase(const Key& key) noexcept
+        {
+            auto node = FindNode(key, hash_(key));
+            if (node == nullptr)
+            {
+                return 0;
+            }
+
+            erase(const_iterator{this, node});
+            return 1;
+        }
+
+        // destroy all elements, nodes and buckets are kept for reuse
+        void clear() noexcept
+        {
+            while (first_ != nullptr)
+            {
+                erase(begin());
+            }
+        }
+
+        TArena& GetArena() const noexcept
+        {
+            return *arena_;
+        }
+
+    private:
+        // fibonacci hashing spreads weak hashes such as identity over all buckets
+        size_t GetBucketIndex(size_t hash) const noexcept
+        {
+            return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> bucket_shift_);
+        }
+
+        Node* FindNode(const Key& key, size_t hash) const noexcept
+        {
+            if (bucket_count_ == 0)
+            {
+                return nullptr;
+            }
+
+            for (auto node = buckets_[GetBucketIndex(hash)]; node != nullptr; node = node->chain)
+            {
+                if (node->hash == hash && equal_(node->value.first, key))
+                {
+                    return node;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // regrow buckets to at least n, the old bucket array is left in the arena
+        void Rehash(size_t n)
+        {
+            size_t count = 1;
+            size_t shift = 64;
+            while (count < n || count < kInitialBucketCount)
+            {
+                count *= 2;
+                shift -= 1;
+            }
+
+            auto buckets = detail::AllocateFromArena<Node*>(*arena_, count);
+            std::fill_n(buckets, count, nullptr);
+
+            buckets_      = buckets;
+            bucket_count_ = count;
+            bucket_shift_ = shift;
+
+            for (auto node = first_; node != nullptr; node = node->next)
+            {
+                auto& head = buckets_[GetBucketIndex(node->hash)];
+                node->chain = head;
+                head        = node;
+            }
+        }
+
+        void LinkNode(Node* node)
+        {
+            // keep load factor no more than 1
+            if (size_ + 1 > bucket_count_)
+            {
+                try
+                {
+                    Rehash(bucket_count_ == 0 ? kInitialBucketCount : bucket_count_ * 2);
+                }
+                catch (...)
+                {
+                    node->value.~value_type();
+                    ReleaseNode(node);
+                    throw;
+                }
+            }
+
+            auto& head  = buckets_[GetBucketIndex(node->hash)];
+            node->chain = head;
+            head        = node;
+
+            node->prev = last_;
+            node->next = nullptr;
+            (last_ != nullptr ? last_->next : first_) = node;
+            last_ = node;
+
+            size_ += 1;
+        }
+
+        void UnlinkNode(Node* node) noexcept
+        {
+            auto p = &buckets_[GetBucketIndex(node->hash)];
+            while (*p != node)
+            {
+                p = &(*p)->chain;
+            }
+            *p = node->chain;
+
+            (node->prev != nullptr ? node->prev->next : first_) = node->next;
+            (node->next != nullptr ? node->next->prev : last_)  = node->prev;
+
+            size_ -= 1;
+        }
+
+        Node* AcquireNode()
+        {
+            if (free_list_ != nullptr)
+            {
+                auto node  = free_list_;
+                free_list_ = node->chain;
+                return node;
+            }
+
+            return detail::AllocateFromArena<Node>(*arena_);
+        }
+
+        void ReleaseNode(Node* node) noexcept
+        {
+            node->chain = free_list_;
+            free_list_  = node;
+        }
+
+        TArena* arena_;
+        Hash hash_;
+        KeyEqual equal_;
+
+        Node** buckets_      = nullptr;
+        size_t bucket_count_ = 0;
+        size_t bucket_shift_ = 64;
+
+        // nodes in insertion order
+        Node* first_ = nullptr;
+        Node* last_  = nullptr;
+        size_t size_ = 0;
+
+        // erased nodes linked through chain
+        Node* free_list_ = nullptr;
+    };
+
+} // namespace eds
@@ -0,0 +1,262 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/memory/arena.h"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace eds
+{
+    // ArenaList is a doubly linked list whose nodes are allocated from an arena
+    //
+    // erased nodes are kept in a free list and reused by later insertions, memory is reclaimed with
+    // the arena while elements are destroyed with the list
+    //
+    // NOTE the arena must not be cleared or rewound past the list before it's destroyed
+    template <typename T, typename TArena = Arena>
+    class ArenaList
+    {
+        struct NodeBase
+        {
+            NodeBase* prev;
+            NodeBase* next;
+        };
+
+        struct Node : NodeBase
+        {
+            T value;
+        };
+
+        template <bool IsConst>
+        class Iterator
+        {
+            friend class ArenaList;
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = std::conditional_t<IsConst, const T*, T*>;
+            using reference         = std::conditional_t<IsConst, const T&, T&>;
+
+            Iterator() = default;
+            explicit Iterator(NodeBase* node) noexcept
+                : node_(node) {}
+
+            operator Iterator<true>() const noexcept
+            {
+                return Iterator<true>{node_};
+            }
+
+            reference operator*() const noexcept { return static_cast<Node*>(node_)->value; }
+            pointer operator->() const noexcept { return &static_cast<Node*>(node_)->value; }
+
+            Iterator& operator++() noexcept
+            {
+                node_ = node_->next;
+                return *this;
+            }
+            Iterator operator++(int) noexcept
+            {
+                auto result = *this;
+                node_       = node_->next;
+                return result;
+            }
+            Iterator& operator--() noexcept
+            {
+                node_ = node_->prev;
+                return *this;
+            }
+            Iterator operator--(int) noexcept
+            {
+                auto result = *this;
+                node_       = node_->prev;
+                return result;
+            }
+
+            bool operator==(const Iterator& other) const noexcept { return node_ == other.node_; }
+            bool operator!=(const Iterator& other) const noexcept { return node_ != other.node_; }
+
+        private:
+            NodeBase* node_ = nullptr;
+        };
+
+    public:
+        using value_type      = T;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = T&;
+        using const_reference = const T&;
+        using pointer         = T*;
+        using const_pointer   = const T*;
+        using iterator        = Iterator<false>;
+        using const_iterator  = Iterator<true>;
+
+        explicit ArenaList(TArena& arena) noexcept
+            : arena_(&arena) {}
+
+        EDSLIB_DISABLE_COPYMOVE(ArenaList)
+
+        ~ArenaList()
+        {
+            clear();
+        }
+
+        //
+        // access
+        //
+        reference front() noexcept { return *begin(); }
+        const_reference front() const noexcept { return *begin(); }
+        reference back() noexcept { return *--end(); }
+        const_reference back() const noexcept { return *--end(); }
+
+        //
+        // iterator
+        //
+        iterator begin() noexcept { return iterator{sentinel_.next}; }
+        iterator end() noexcept { return iterator{&sentinel_}; }
+        const_iterator begin() const noexcept { return const_iterator{sentinel_.next}; }
+        const_iterator end() const noexcept { return const_iterator{const_cast<NodeBase*>(&sentinel_)}; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        //
+        // capacity
+        //
+        bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+        size_type size() const noexcept
+        {
+            return size_;
+        }
+
+        //
+        // modifiers
+        //
+
+        // construct an element before pos
+        template <typename... TArgs>
+        iterator emplace(const_iterator pos, TArgs&&... args)
+        {
+            auto node = AcquireNode();
+            try
+            {
+                new (&node->value) T(std::forward<TArgs>(args)...);
+            }
+            catch (...)
+            {
+                ReleaseNode(node);
+                throw;
+            }
+
+            auto next  = pos.node_;
+            node->prev = next->prev;
+            node->next = next;
+
+            next->prev->next = node;
+            next->prev       = node;
+            size_ += 1;
+
+            return iterator{node};
+        }
+        iterator insert(const_iterator pos, const T& value)
+        {
+            return emplace(pos, value);
+        }
+        iterator insert(const_iterator pos, T&& value)
+        {
+            return emplace(pos, std::move(value));
+        }
+
+        template <typename... TArgs>
+        reference emplace_back(TArgs&&... args)
+        {
+            return *emplace(end(), std::forward<TArgs>(args)...);
+        }
+        template <typename... TArgs>
+        reference emplace_front(TArgs&&... args)
+        {
+            return *emplace(begin(), std::forward<TArgs>(args)...);
+        }
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+        void push_front(const T& value) { emplace_front(value); }
+        void push_front(T&& value) { emplace_front(std::move(value)); }
+
+        // destroy the element at pos, returns the iterator following it
+        iterator erase(const_iterator pos) noexcept
+        {
+            assert(pos != end());
+
+            auto node = static_cast<Node*>(pos.node_);
+            auto next = node->next;
+
+            node->prev->next = next;
+            next->prev       = node->prev;
+            size_ -= 1;
+
+            node->value.~T();
+            ReleaseNode(node);
+
+            return iterator{next};
+        }
+
+        void pop_back() noexcept { erase(--end()); }
+        void pop_front() noexcept { erase(begin()); }
+
+        // destroy all elements, nodes are kept for reuse
+        void clear() noexcept
+        {
+            while (size_ > 0)
+            {
+                pop_back();
+            }
+        }
+
+        TArena& GetArena() const noexcept
+        {
+            return *arena_;
+        }
+
+    private:
+        Node* AcquireNode()
+        {
+            if (free_list_ != nullptr)
+            {
+                auto node  = static_cast<Node*>(free_list_);
+                free_list_ = free_list_->next;
+                return node;
+            }
+
+            return detail::AllocateFromArena<Node>(*arena_);
+        }
+
+        void ReleaseNode(Node* node) noexcept
+        {
+            node->next = free_list_;
+            free_list_ = node;
+        }
+
+        TArena* arena_;
+
+        // the sentinel links the last node to the first one
+        NodeBase sentinel_ = {&sentinel_, &sentinel_};
+        size_t size_       = 0;
+
+        // erased nodes linked through next
+        NodeBase* free_list_ = nullptr;
+    };
+
+} // namespace eds
@@ -0,0 +1,382 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/memory/arena.h"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace eds
+{
+    namespace detail
+    {
+        // index of the highest set bit, x must not be 0
+        inline size_t FloorLog2(size_t x) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(x);
+#else
+            size_t result = 0;
+            while (x >>= 1)
+            {
+                result += 1;
+            }
+
+            return result;
+#endif
+        }
+    } // namespace detail
+
+    // ArenaVector is a sequence container whose storage comes from an arena
+    //
+    // storage grows by chaining segments of doubling capacity instead of reallocating, so elements
+    // are never relocated and references stay valid until they're erased. each segment is contiguous,
+    // memory is reclaimed with the arena while elements are destroyed with the vector
+    //
+    // NOTE the arena must not be cleared or rewound past the vector before it's destroyed
+    template <typename T, typename TArena = Arena>
+    class ArenaVector
+    {
+        template <bool IsConst>
+        class Iterator;
+
+    public:
+        using value_type      = T;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = T&;
+        using const_reference = const T&;
+        using pointer         = T*;
+        using const_pointer   = const T*;
+        using iterator        = Iterator<false>;
+        using const_iterator  = Iterator<true>;
+
+        // capacity of the first segment, each following segment doubles
+        static constexpr size_t kFirstSegmentSize = sizeof(T) < 32 ? 128 / sizeof(T) : 4;
+        static constexpr size_t kMaxSegmentCount  = 32;
+
+        explicit ArenaVector(TArena& arena) noexcept
+            : arena_(&arena) {}
+
+        EDSLIB_DISABLE_COPYMOVE(ArenaVector)
+
+        ~ArenaVector()
+        {
+            clear();
+        }
+
+        //
+        // access
+        //
+        reference operator[](size_type pos) noexcept
+        {
+            assert(pos < size_);
+            return *Locate(pos);
+        }
+        const_reference operator[](size_type pos) const noexcept
+        {
+            assert(pos < size_);
+            return *Locate(pos);
+        }
+
+        reference front() noexcept { return (*this)[0]; }
+        const_reference front() const noexcept { return (*this)[0]; }
+        reference back() noexcept { return cursor_[-1]; }
+        const_reference back() const noexcept { return cursor_[-1]; }
+
+        //
+        // iterator
+        //
+        iterator begin() noexcept { return iterator{this, 0}; }
+        iterator end() noexcept { return iterator{this, size_}; }
+        const_iterator begin() const noexcept { return const_iterator{this, 0}; }
+        const_iterator end() const noexcept { return const_iterator{this, size_}; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        //
+        // capacity
+        //
+        bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+        size_type size() const noexcept
+        {
+            return size_;
+        }
+        size_type capacity() const noexcept
+        {
+            return GetSegmentStart(segment_count_);
+        }
+
+        // allocate segments ahead so that n elements fit without further allocation
+        void reserve(size_type n)
+        {
+            while (capacity() < n)
+            {
+                AllocateSegment();
+            }
+        }
+
+        //
+        // modifiers
+        //
+        template <typename... TArgs>
+        reference emplace_back(TArgs&&... args)
+        {
+            if (cursor_ != segment_end_)
+            {
+                new (cursor_) T(std::forward<TArgs>(args)...);
+            }
+            else
+            {
+                // the cursor is moved only after the element is constructed, so that a throwing
+                // constructor leaves the vector as it was
+                auto next = PrepareNextSegment();
+                new (segments_[next]) T(std::forward<TArgs>(args)...);
+                EnterSegment(next);
+            }
+            size_ += 1;
+
+            return *cursor_++;
+        }
+        void push_back(const T& value)
+        {
+            emplace_back(value);
+        }
+        void push_back(T&& value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        void pop_back() noexcept
+        {
+            assert(size_ > 0);
+
+            cursor_ -= 1;
+            cursor_->~T();
+            size_ -= 1;
+
+            // keep the cursor right after the back element
+            if (cursor_ == segments_[tail_segment_] && tail_segment_ > 0)
+            {
+                tail_segment_ -= 1;
+                cursor_      = segments_[tail_segment_] + GetSegmentSize(tail_segment_);
+                segment_end_ = cursor_;
+            }
+        }
+
+        // destroy all elements, segments are kept for reuse
+        void clear() noexcept
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                while (size_ > 0)
+                {
+                    pop_back();
+                }
+            }
+
+            size_         = 0;
+            tail_segment_ = 0;
+            cursor_       = segment_count_ > 0 ? segments_[0] : nullptr;
+            segment_end_  = segment_count_ > 0 ? segments_[0] + GetSegmentSize(0) : nullptr;
+        }
+
+        TArena& GetArena() const noexcept
+        {
+            return *arena_;
+        }
+
+    private:
+        static constexpr size_t GetSegmentSize(size_t index) noexcept
+        {
+            return kFirstSegmentSize << index;
+        }
+
+        // index of the first element in the segment
+        static constexpr size_t GetSegmentStart(size_t index) noexcept
+        {
+            return kFirstSegmentSize * ((size_t{1} << index) - 1);
+        }
+
+        static size_t GetSegmentIndex(size_t pos) noexcept
+        {
+            return detail::FloorLog2(pos / kFirstSegmentSize + 1);
+        }
+
+        T* Locate(size_t pos) const noexcept
+        {
+            auto index = GetSegmentIndex(pos);
+
+            return segments_[index] + (pos - GetSegmentStart(index));
+        }
+
+        void AllocateSegment()
+        {
+            assert(segment_count_ < kMaxSegmentCount);
+
+            segments_[segment_count_] = detail::AllocateFromArena<T>(*arena_, GetSegmentSize(segment_count_));
+            segment_count_ += 1;
+        }
+
+        // index of the segment after the tail one, which is allocated if necessary
+        size_t PrepareNextSegment()
+        {
+            auto next = cursor_ == nullptr ? 0 : tail_segment_ + 1;
+            if (next == segment_count_)
+            {
+                AllocateSegment();
+            }
+
+            return next;
+        }
+
+        // move the back cursor to the start of segment next
+        void EnterSegment(size_t next) noexcept
+        {
+            tail_segment_ = next;
+            cursor_       = segments_[next];
+            segment_end_  = segments_[next] + GetSegmentSize(next);
+        }
+
+        TArena* arena_;
+
+        size_t size_ = 0;
+
+        // where the next element is constructed, and the end of the segment it's in
+        T* cursor_           = nullptr;
+        T* segment_end_      = nullptr;
+        size_t tail_segment_ = 0;
+
+        T* segments_[kMaxSegmentCount] = {};
+        size_t segment_count_          = 0;
+    };
+
+    // iterates element by element within a segment and looks up the next segment at its boundary
+    template <typename T, typename TArena>
+    template <bool IsConst>
+    class ArenaVector<T, TArena>::Iterator
+    {
+        using Owner = std::conditional_t<IsConst, const ArenaVector, ArenaVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<IsConst, const T*, T*>;
+        using reference         = std::conditional_t<IsConst, const T&, T&>;
+
+        Iterator() = default;
+        Iterator(Owner* owner, size_t pos) noexcept
+            : owner_(owner), pos_(pos)
+        {
+            Seek();
+        }
+
+        operator Iterator<true>() const noexcept
+        {
+            return Iterator<true>{owner_, pos_};
+        }
+
+        reference operator*() const noexcept { return *ptr_; }
+        pointer operator->() const noexcept { return ptr_; }
+        reference operator[](difference_type n) const noexcept { return (*owner_)[pos_ + n]; }
+
+        Iterator& operator++() noexcept
+        {
+            pos_ += 1;
+            if (++ptr_ == segment_end_)
+            {
+                Seek();
+            }
+
+            return *this;
+        }
+        Iterator operator++(int) noexcept
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+        Iterator& operator--() noexcept
+        {
+            pos_ -= 1;
+            Seek();
+            return *this;
+        }
+        Iterator operator--(int) noexcept
+        {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        Iterator& operator+=(difference_type n) noexcept
+        {
+            pos_ += n;
+            Seek();
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) noexcept
+        {
+            return *this += -n;
+        }
+        Iterator operator+(difference_type n) const noexcept
+        {
+            return Iterator{owner_, pos_ + n};
+        }
+        Iterator operator-(difference_type n) const noexcept
+        {
+            return Iterator{owner_, pos_ - n};
+        }
+        friend Iterator operator+(difference_type n, const Iterator& it) noexcept
+        {
+            return it + n;
+        }
+        difference_type operator-(const Iterator& other) const noexcept
+        {
+            return static_cast<difference_type>(pos_) - static_cast<difference_type>(other.pos_);
+        }
+
+        bool operator==(const Iterator& other) const noexcept { return pos_ == other.pos_; }
+        bool operator!=(const Iterator& other) const noexcept { return pos_ != other.pos_; }
+        bool operator<(const Iterator& other) const noexcept { return pos_ < other.pos_; }
+        bool operator>(const Iterator& other) const noexcept { return pos_ > other.pos_; }
+        bool operator<=(const Iterator& other) const noexcept { return pos_ <= other.pos_; }
+        bool operator>=(const Iterator& other) const noexcept { return pos_ >= other.pos_; }
+
+    private:
+        void Seek() noexcept
+        {
+            if (pos_ >= owner_->size_)
+            {
+                ptr_ = segment_end_ = nullptr;
+                return;
+            }
+
+            auto index   = GetSegmentIndex(pos_);
+            auto segment = owner_->segments_[index];
+
+            ptr_         = segment + (pos_ - GetSegmentStart(index));
+            segment_end_ = segment + GetSegmentSize(index);
+        }
+
+        Owner* owner_ = nullptr;
+        size_t pos_   = 0;
+
+        pointer ptr_         = nullptr;
+        pointer segment_end_ = nullptr;
+    };
+
+} // namespace eds
@@ -45,19 +45,20 @@ namespace eds
     public:
         // ctor
         FlatSet() {}
+        explicit FlatSet(const Allocator& alloc)
+            : container_(alloc) {}
         template <typename InputIt>
         FlatSet(InputIt first, InputIt last)
         {
             assign(first, last);
         }
         FlatSet(const FlatSet& other)
+            : container_(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
         {
             assign(other.begin(), other.end());
         }
         FlatSet(FlatSet&& other)
-        {
-            swap(other);
-        }
+            : container_(std::move(other.container_)) {}
         FlatSet(std::initializer_list<Key> ilist)
         {
             assign(ilist);
@@ -96,6 +97,11 @@ namespace eds
             assign(ilist.begin(), ilist.end());
         }
 
+        allocator_type get_allocator() const
+        {
+            return container_.get_allocator();
+        }
+
         //
         // access
         //
@@ -14,6 +14,15 @@ namespace eds
     EDSLIB_DISABLE_COPY(KLASS_NAME)         \
     EDSLIB_DISABLE_MOVE(KLASS_NAME)
 
+// keep slow paths out of line so that the fast path stays small enough to inline
+#if defined(_MSC_VER)
+#define EDSLIB_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__) || defined(__clang__)
+#define EDSLIB_NOINLINE __attribute__((noinline))
+#else
+#define EDSLIB_NOINLINE
+#endif
+
     class NonCopyable
     {
     protected:
@@ -0,0 +1,139 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/memory/arena.h"
+#include <memory_resource>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace eds
+{
+    // ArenaResource adapts an arena to std::pmr::memory_resource
+    // deallocation is a no-op, memory is reclaimed when the arena is cleared
+    template <typename TArena = Arena>
+    class ArenaResource : public std::pmr::memory_resource
+    {
+    public:
+        ArenaResource(TArena& arena) noexcept
+            : arena_(&arena) {}
+
+        TArena& GetArena() const noexcept
+        {
+            return *arena_;
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            auto result = arena_->AllocateAligned(bytes, alignment);
+            if (result == nullptr)
+            {
+                throw std::bad_alloc{};
+            }
+
+            return result;
+        }
+
+        void do_deallocate(void*, size_t, size_t) override
+        {
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+        TArena* arena_;
+    };
+
+    // ArenaAllocator is a standard allocator that allocates from an arena
+    // deallocation is a no-op, memory is reclaimed when the arena is cleared
+    template <typename T, typename TArena = Arena>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+        using is_always_equal                        = std::false_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = ArenaAllocator<U, TArena>;
+        };
+
+        ArenaAllocator(TArena& arena) noexcept
+            : arena_(&arena) {}
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U, TArena>& other) noexcept
+            : arena_(&other.GetArena()) {}
+
+        T* allocate(size_t n)
+        {
+            if (n > max_size())
+            {
+                throw std::bad_array_new_length{};
+            }
+
+            auto p = arena_->AllocateAligned(sizeof(T) * n, alignof(T));
+            if (p == nullptr)
+            {
+                throw std::bad_alloc{};
+            }
+
+            return reinterpret_cast<T*>(p);
+        }
+
+        void deallocate(T*, size_t) noexcept
+        {
+        }
+
+        // grow the buffer at p, which must be the most recent allocation, from old_n to new_n elements
+        // arena-aware containers could use this to avoid relocation
+        bool try_extend(T* p, size_t old_n, size_t new_n) noexcept
+        {
+            if (new_n > max_size())
+            {
+                return false;
+            }
+
+            return arena_->TryExtend(p, sizeof(T) * old_n, sizeof(T) * new_n);
+        }
+
+        size_t max_size() const noexcept
+        {
+            return SIZE_MAX / sizeof(T);
+        }
+
+        TArena& GetArena() const noexcept
+        {
+            return *arena_;
+        }
+
+    private:
+        TArena* arena_;
+    };
+
+    template <typename T, typename U, typename TArena>
+    inline bool operator==(const ArenaAllocator<T, TArena>& lhs, const ArenaAllocator<U, TArena>& rhs) noexcept
+    {
+        return &lhs.GetArena() == &rhs.GetArena();
+    }
+    template <typename T, typename U, typename TArena>
+    inline bool operator!=(const ArenaAllocator<T, TArena>& lhs, const ArenaAllocator<U, TArena>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+} // namespace eds
@@ -0,0 +1,211 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/memory/arena.h"
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eds
+{
+    // ArenaHandle refers to an object in a HandleArena, it stays valid across compaction and
+    // is detected as stale once the object is destroyed
+    template <typename T>
+    struct ArenaHandle
+    {
+        uint32_t index      = 0;
+        // 0 for the null handle
+        uint32_t generation = 0;
+
+        bool IsNull() const noexcept
+        {
+            return generation == 0;
+        }
+
+        bool operator==(const ArenaHandle& other) const noexcept
+        {
+            return index == other.index && generation == other.generation;
+        }
+        bool operator!=(const ArenaHandle& other) const noexcept
+        {
+            return !(*this == other);
+        }
+    };
+
+    // HandleArena constructs objects of type T in an arena and hands out generational handles
+    // instead of pointers, so that live objects could be relocated by Compact
+    //
+    // memory of destroyed objects is not reused until Compact moves all live objects into a fresh
+    // arena, in slot order, and releases the old one at once
+    //
+    // NOTE pointers returned by Get are invalidated by Compact
+    template <typename T, typename MemoryProvider = HeapGrowableMemoryProvider>
+    class HandleArena
+    {
+    public:
+        using Handle = ArenaHandle<T>;
+
+        HandleArena()
+            : arena_(std::make_unique<BasicArena<MemoryProvider>>()) {}
+
+        EDSLIB_DISABLE_COPYMOVE(HandleArena)
+
+        ~HandleArena()
+        {
+            for (auto& slot : slots_)
+            {
+                if (slot.object != nullptr)
+                {
+                    slot.object->~T();
+                }
+            }
+        }
+
+        template <typename... TArgs>
+        Handle Create(TArgs&&... args)
+        {
+            auto p = arena_->AllocateAligned(sizeof(T), alignof(T));
+            if (p == nullptr)
+            {
+                throw std::bad_alloc{};
+            }
+
+            auto index = AcquireSlot();
+            auto& slot = slots_[index];
+            try
+            {
+                slot.object = new (p) T(std::forward<TArgs>(args)...);
+            }
+            catch (...)
+            {
+                ReleaseSlot(index);
+                throw;
+            }
+
+            live_count_ += 1;
+            return Handle{index, slot.generation};
+        }
+
+        // destroy the object, handle and its copies become stale
+        void Destroy(Handle handle) noexcept
+        {
+            assert(IsValid(handle));
+
+            slots_[handle.index].object->~T();
+            ReleaseSlot(handle.index);
+            live_count_ -= 1;
+        }
+
+        bool IsValid(Handle handle) const noexcept
+        {
+            return !handle.IsNull() && handle.index < slots_.size() &&
+                   slots_[handle.index].generation == handle.generation;
+        }
+
+        // returns nullptr if handle is stale
+        T* Get(Handle handle) const noexcept
+        {
+            return IsValid(handle) ? slots_[handle.index].object : nullptr;
+        }
+
+        // relocate live objects into a fresh arena and release memory held by the old one
+        void Compact()
+        {
+            static_assert(std::is_nothrow_move_constructible_v<T>, "T must be nothrow move constructible for compaction");
+
+            // storage of all live objects is allocated up front, so that a failure leaves every
+            // object where it was and the loop below could not throw
+            auto fresh = std::make_unique<BasicArena<MemoryProvider>>();
+            if (live_count_ > 0)
+            {
+                auto p = static_cast<T*>(fresh->AllocateAligned(sizeof(T) * live_count_, alignof(T)));
+                if (p == nullptr)
+                {
+                    throw std::bad_alloc{};
+                }
+
+                for (auto& slot : slots_)
+                {
+                    if (slot.object != nullptr)
+                    {
+                        auto moved = new (p++) T(std::move(*slot.object));
+                        slot.object->~T();
+                        slot.object = moved;
+                    }
+                }
+            }
+
+            arena_ = std::move(fresh);
+        }
+
+        // count of live objects
+        size_t Count() const noexcept
+        {
+            return live_count_;
+        }
+
+        size_t GetByteAllocated() const noexcept
+        {
+            return arena_->GetByteAllocated();
+        }
+
+        // bytes taken by live objects and by destroyed ones not yet compacted away
+        size_t GetByteUsed() const noexcept
+        {
+            return arena_->GetByteUsed();
+        }
+
+    private:
+        struct Slot
+        {
+            // nullptr if the slot is free
+            T* object;
+            uint32_t generation;
+            // next free slot if the slot is free
+            uint32_t next_free;
+        };
+
+        static constexpr uint32_t kEndOfFreeList = ~uint32_t{0};
+
+        uint32_t AcquireSlot()
+        {
+            if (free_head_ != kEndOfFreeList)
+            {
+                auto index = free_head_;
+                free_head_ = slots_[index].next_free;
+                return index;
+            }
+
+            slots_.push_back(Slot{nullptr, 1, kEndOfFreeList});
+            return static_cast<uint32_t>(slots_.size() - 1);
+        }
+
+        void ReleaseSlot(uint32_t index) noexcept
+        {
+            auto& slot = slots_[index];
+
+            // generation 0 is reserved for the null handle
+            slot.object     = nullptr;
+            slot.generation = slot.generation + 1 != 0 ? slot.generation + 1 : 1;
+            slot.next_free  = free_head_;
+            free_head_      = index;
+        }
+
+        std::unique_ptr<BasicArena<MemoryProvider>> arena_;
+
+        std::vector<Slot> slots_;
+        uint32_t free_head_ = kEndOfFreeList;
+        size_t live_count_  = 0;
+    };
+
+} // namespace eds
@@ -0,0 +1,226 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/memory/arena.h"
+#include "edslib/memory/mmap-provider.h"
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace eds
+{
+    // RelPtr is a pointer stored as an offset from its own address, so a graph built from RelPtr
+    // stays valid wherever the memory holding it is mapped
+    //
+    // NOTE copying a RelPtr re-targets the copy to the same object, not the same offset
+    template <typename T>
+    class RelPtr
+    {
+    public:
+        RelPtr() noexcept {}
+        RelPtr(T* p) noexcept
+        {
+            Set(p);
+        }
+        RelPtr(const RelPtr& other) noexcept
+        {
+            Set(other.Get());
+        }
+
+        RelPtr& operator=(T* p) noexcept
+        {
+            Set(p);
+            return *this;
+        }
+        RelPtr& operator=(const RelPtr& other) noexcept
+        {
+            Set(other.Get());
+            return *this;
+        }
+
+        T* Get() const noexcept
+        {
+            return offset_ == 0 ? nullptr
+                                : reinterpret_cast<T*>(reinterpret_cast<intptr_t>(this) + offset_);
+        }
+
+        T& operator*() const noexcept { return *Get(); }
+        T* operator->() const noexcept { return Get(); }
+        explicit operator bool() const noexcept { return offset_ != 0; }
+
+    private:
+        void Set(T* p) noexcept
+        {
+            // NOTE a RelPtr pointing to itself is indistinguishable from null
+            offset_ = p == nullptr ? 0 : reinterpret_cast<intptr_t>(p) - reinterpret_cast<intptr_t>(this);
+        }
+
+        intptr_t offset_ = 0;
+    };
+
+    constexpr uint32_t kSnapshotMagic   = 0x41534445; // "EDSA" in little endian
+    constexpr uint32_t kSnapshotVersion = 1;
+
+    // header of a snapshot file, followed by the arena memory
+    // aligned so that the data keeps the alignment of objects in it once mapped
+    struct alignas(64) SnapshotHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        // bytes of arena memory following the header
+        uint64_t data_size;
+        // offset of the root object from the start of the data
+        uint64_t root_offset;
+        // sizeof(void*) of the writer, RelPtr layout depends on it
+        uint32_t pointer_size;
+    };
+
+    // write memory of an mmap-backed arena to path, root must be an object in that arena
+    // objects reachable from root must refer to each other with RelPtr only, and need no destructor
+    template <bool UseHugePages, bool Prefault>
+    inline bool SaveSnapshot(const BasicArena<MmapMemoryProvider<UseHugePages, Prefault>>& arena,
+                             const void* root, const char* path)
+    {
+        auto data      = arena.GetProvider().Data();
+        auto size      = arena.GetByteUsed();
+        auto root_addr = reinterpret_cast<const uint8_t*>(root);
+        if (root_addr < data || root_addr >= data + size)
+        {
+            return false;
+        }
+
+        SnapshotHeader header = {};
+        header.magic          = kSnapshotMagic;
+        header.version        = kSnapshotVersion;
+        header.data_size      = size;
+        header.root_offset    = static_cast<uint64_t>(root_addr - data);
+        header.pointer_size   = sizeof(void*);
+
+        auto file = fopen(path, "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        auto ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(data, 1, size, file) == size;
+        ok      = fclose(file) == 0 && ok;
+
+        return ok;
+    }
+
+    // MappedSnapshot maps a file written by SaveSnapshot read-only, pages are loaded on first access
+    class MappedSnapshot
+    {
+    public:
+        MappedSnapshot() {}
+        explicit MappedSnapshot(const char* path)
+        {
+            Open(path);
+        }
+
+        EDSLIB_DISABLE_COPYMOVE(MappedSnapshot)
+
+        ~MappedSnapshot()
+        {
+            Close();
+        }
+
+        // map the file and validate its header, returns false if it's not a valid snapshot
+        bool Open(const char* path) noexcept
+        {
+            Close();
+
+            auto fd = open(path, O_RDONLY);
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            struct stat st;
+            if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader))
+            {
+                close(fd);
+                return false;
+            }
+
+            auto size = static_cast<size_t>(st.st_size);
+            auto p    = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (p == MAP_FAILED)
+            {
+                return false;
+            }
+
+            mapping_      = reinterpret_cast<uint8_t*>(p);
+            mapping_size_ = size;
+            if (!Validate())
+            {
+                Close();
+                return false;
+            }
+
+            return true;
+        }
+
+        void Close() noexcept
+        {
+            if (mapping_ != nullptr)
+            {
+                munmap(mapping_, mapping_size_);
+            }
+
+            mapping_      = nullptr;
+            mapping_size_ = 0;
+        }
+
+        bool IsOpen() const noexcept
+        {
+            return mapping_ != nullptr;
+        }
+
+        template <typename T>
+        const T* Root() const noexcept
+        {
+            return IsOpen() ? reinterpret_cast<const T*>(Data() + GetHeader().root_offset) : nullptr;
+        }
+
+        const uint8_t* Data() const noexcept
+        {
+            return mapping_ + sizeof(SnapshotHeader);
+        }
+
+        size_t Size() const noexcept
+        {
+            return IsOpen() ? GetHeader().data_size : 0;
+        }
+
+    private:
+        const SnapshotHeader& GetHeader() const noexcept
+        {
+            return *reinterpret_cast<const SnapshotHeader*>(mapping_);
+        }
+
+        bool Validate() const noexcept
+        {
+            const auto& header = GetHeader();
+
+            return header.magic == kSnapshotMagic && header.version == kSnapshotVersion &&
+                   header.pointer_size == sizeof(void*) &&
+                   header.data_size == mapping_size_ - sizeof(SnapshotHeader) &&
+                   header.root_offset < header.data_size;
+        }
+
+        uint8_t* mapping_    = nullptr;
+        size_t mapping_size_ = 0;
+    };
+
+} // namespace eds
@@ -8,16 +8,45 @@
 #pragma once
 #include "edslib/lang-utils.h"
 #include "edslib/ptr-arithmetic.h"
+#include "edslib/type-utils.h"
+#include "edslib/memory/block-recycler.h"
 #include <deque>
 #include <cassert>
 #include <algorithm>
 #include <type_traits>
 #include <memory>
+#include <iterator>
+#include <new>
+#include <atomic>
 #include <cstdint>
 
 namespace eds
 {
     constexpr size_t kDefaultWorkspaceSize = 4096;
+    // alignment of memory returned by a provider if not specified
+    constexpr size_t kDefaultAlignment = alignof(std::max_align_t);
+
+    namespace detail
+    {
+        // the most padding needed to align memory that is already aligned to kDefaultAlignment
+        constexpr size_t WorstPadding(size_t align) noexcept
+        {
+            return align > kDefaultAlignment ? align - kDefaultAlignment : 0;
+        }
+
+        // bytes of n objects of T placed offset bytes into an allocation, throw std::bad_alloc if
+        // it doesn't fit in size_t
+        template <typename T>
+        constexpr size_t ArrayAllocSize(size_t n, size_t offset = 0)
+        {
+            if (n > (SIZE_MAX - offset) / sizeof(T))
+            {
+                throw std::bad_alloc{};
+            }
+
+            return offset + sizeof(T) * n;
+        }
+    } // namespace detail
 
     template <size_t BufferSize = kDefaultWorkspaceSize>
     class StackWorkspaceMemoryProvider
@@ -28,15 +57,16 @@ namespace eds
 
         EDSLIB_DISABLE_COPYMOVE(StackWorkspaceMemoryProvider)
 
-        void* Allocate(size_t sz) noexcept
+        void* Allocate(size_t sz, size_t align = kDefaultAlignment) noexcept
         {
-            if (offset_ + sz > BufferSize)
+            auto offset = offset_ + PaddingToAlign(&buffer_[offset_], align);
+            if (offset + sz > BufferSize)
             {
                 return nullptr;
             }
 
-            void* result = &buffer_[offset_];
-            offset_ += sz;
+            void* result = &buffer_[offset];
+            offset_      = offset + sz;
 
             return result;
         }
@@ -46,6 +76,31 @@ namespace eds
             offset_ = 0;
         }
 
+        using Marker = size_t;
+
+        Marker Mark() const noexcept
+        {
+            return offset_;
+        }
+
+        void Rewind(Marker marker) noexcept
+        {
+            assert(marker <= offset_);
+            offset_ = marker;
+        }
+
+        // grow the last allocation in place if possible
+        bool TryExtend(void* p, size_t old_sz, size_t new_sz) noexcept
+        {
+            if (old_sz > offset_ || p != &buffer_[offset_ - old_sz] || offset_ - old_sz + new_sz > BufferSize)
+            {
+                return false;
+            }
+
+            offset_ = offset_ - old_sz + new_sz;
+            return true;
+        }
+
         size_t GetByteAllocated() const noexcept
         {
             return BufferSize;
@@ -57,7 +112,7 @@ namespace eds
         }
 
     private:
-        uint8_t buffer_[BufferSize];
+        alignas(kDefaultAlignment) uint8_t buffer_[BufferSize];
 
         size_t offset_ = 0;
     };
@@ -76,15 +131,16 @@ namespace eds
 
         EDSLIB_DISABLE_COPYMOVE(HeapWorkspaceMemoryProvider)
 
-        void* Allocate(size_t sz) noexcept
+        void* Allocate(size_t sz, size_t align = kDefaultAlignment) noexcept
         {
-            if (offset_ + sz > buffer_size_)
+            auto offset = offset_ + PaddingToAlign(&buffer_[offset_], align);
+            if (offset + sz > buffer_size_)
             {
                 return nullptr;
             }
 
-            void* result = &buffer_[offset_];
-            offset_ += sz;
+            void* result = &buffer_[offset];
+            offset_      = offset + sz;
 
             return result;
         }
@@ -94,6 +150,31 @@ namespace eds
             offset_ = 0;
         }
 
+        using Marker = size_t;
+
+        Marker Mark() const noexcept
+        {
+            return offset_;
+        }
+
+        void Rewind(Marker marker) noexcept
+        {
+            assert(marker <= offset_);
+            offset_ = marker;
+        }
+
+        // grow the last allocation in place if possible
+        bool TryExtend(void* p, size_t old_sz, size_t new_sz) noexcept
+        {
+            if (old_sz > offset_ || p != &buffer_[offset_ - old_sz] || offset_ - old_sz + new_sz > buffer_size_)
+            {
+                return false;
+            }
+
+            offset_ = offset_ - old_sz + new_sz;
+            return true;
+        }
+
         size_t GetByteAllocated() const noexcept
         {
             return buffer_size_;
@@ -111,52 +192,350 @@ namespace eds
         size_t offset_;
     };
 
-    class HeapGrowableMemoryProvider
+    // NullArenaStats collects nothing and costs nothing
+    struct NullArenaStats
+    {
+        void OnAllocate(size_t) noexcept {}
+        void OnBigChunk(size_t) noexcept {}
+        void OnBlockAbandoned(size_t) noexcept {}
+        void OnUsage(size_t, size_t) noexcept {}
+    };
+
+    // ArenaStats collects allocation statistics of a memory provider, counters accumulate across Clear
+    struct ArenaStats
+    {
+        // bucket i counts allocations of size in (2^(i-1), 2^i], the last bucket counts all larger ones
+        static constexpr size_t kHistogramSize = 16;
+
+        size_t allocation_count                     = 0;
+        size_t allocation_histogram[kHistogramSize] = {};
+        size_t big_chunk_count                      = 0;
+        size_t big_chunk_bytes                      = 0;
+        size_t abandoned_block_count                = 0;
+        // bytes left unused at the tail of abandoned blocks
+        size_t fragmented_bytes                     = 0;
+        size_t peak_byte_used                       = 0;
+        size_t peak_byte_allocated                  = 0;
+
+        void OnAllocate(size_t sz) noexcept
+        {
+            size_t index = 0;
+            while (index + 1 < kHistogramSize && (size_t{1} << index) < sz)
+            {
+                index += 1;
+            }
+
+            allocation_count += 1;
+            allocation_histogram[index] += 1;
+        }
+
+        void OnBigChunk(size_t sz) noexcept
+        {
+            big_chunk_count += 1;
+            big_chunk_bytes += sz;
+        }
+
+        void OnBlockAbandoned(size_t wasted) noexcept
+        {
+            abandoned_block_count += 1;
+            fragmented_bytes += wasted;
+        }
+
+        void OnUsage(size_t used, size_t allocated) noexcept
+        {
+            peak_byte_used      = std::max(peak_byte_used, used);
+            peak_byte_allocated = std::max(peak_byte_allocated, allocated);
+        }
+    };
+
+    // A growth policy decides sizes of pool blocks in a BasicHeapGrowableMemoryProvider,
+    // sizes are in bytes with the block header included
+    //
+    // required members:
+    //   kBigChunkThreshold:     requests larger than this bypass the pool
+    //   kFailureToleranceCount: times a block may fail to serve a request before it's abandoned
+    //   InitialBlockSize():     size of the first block
+    //   NextBlockSize(last):    size of the block appended after one of size last
+    //   OnClear(used, next):    size of the first block after Clear, given bytes used in pool blocks
+    //                           and the size that would have been used next
+    struct DefaultGrowthThresholds
+    {
+        static constexpr size_t kBigChunkThreshold     = 2048;
+        static constexpr size_t kFailureToleranceCount = 8;
+    };
+
+    // block size grows by Factor every time up to MaximumSize
+    template <size_t InitialSize = 4096, size_t MaximumSize = 16 * 4096, size_t Factor = 2>
+    struct GeometricGrowth : DefaultGrowthThresholds
+    {
+        static_assert(InitialSize <= MaximumSize && Factor >= 1);
+
+        size_t InitialBlockSize() const noexcept
+        {
+            return InitialSize;
+        }
+
+        size_t NextBlockSize(size_t last) const noexcept
+        {
+            return std::min(last * Factor, std::max(MaximumSize, last));
+        }
+
+        size_t OnClear(size_t, size_t next) const noexcept
+        {
+            return next;
+        }
+    };
+
+    // every block has the same size
+    template <size_t Size = 4096>
+    struct FixedGrowth : DefaultGrowthThresholds
+    {
+        size_t InitialBlockSize() const noexcept
+        {
+            return Size;
+        }
+
+        size_t NextBlockSize(size_t) const noexcept
+        {
+            return Size;
+        }
+
+        size_t OnClear(size_t, size_t) const noexcept
+        {
+            return Size;
+        }
+    };
+
+    // geometric growth with parameters tunable at runtime
+    class RuntimeGrowth : public DefaultGrowthThresholds
+    {
+    public:
+        size_t InitialBlockSize() const noexcept
+        {
+            return initial_size_;
+        }
+
+        size_t NextBlockSize(size_t last) const noexcept
+        {
+            return std::min(static_cast<size_t>(last * growth_factor_), std::max(maximum_size_, last));
+        }
+
+        size_t OnClear(size_t, size_t next) const noexcept
+        {
+            return next;
+        }
+
+        void SetInitialBlockSize(size_t sz) noexcept
+        {
+            initial_size_ = sz;
+        }
+
+        void SetMaximumBlockSize(size_t sz) noexcept
+        {
+            maximum_size_ = sz;
+        }
+
+        void SetGrowthFactor(float factor) noexcept
+        {
+            assert(factor >= 1);
+            growth_factor_ = factor;
+        }
+
+    private:
+        size_t initial_size_ = 4096;
+        size_t maximum_size_ = 16 * 4096;
+        float growth_factor_ = 2;
+    };
+
+    // geometric growth whose first block is sized after the footprint of previous Clear cycles,
+    // so that steady-state workloads fit into a single block
+    template <size_t MaximumLearnedSize = 1 << 20, size_t InitialSize = 4096, size_t MaximumSize = 16 * 4096>
+    class AdaptiveGrowth : public DefaultGrowthThresholds
     {
     public:
-        HeapGrowableMemoryProvider() {}
-        HeapGrowableMemoryProvider(size_t sz)
-            : next_block_sz_(sz) {}
+        size_t InitialBlockSize() const noexcept
+        {
+            return InitialSize;
+        }
 
-        EDSLIB_DISABLE_COPYMOVE(HeapGrowableMemoryProvider)
+        size_t NextBlockSize(size_t last) const noexcept
+        {
+            return std::min(last * 2, std::max(MaximumSize, last));
+        }
 
-        ~HeapGrowableMemoryProvider()
+        size_t OnClear(size_t used, size_t) noexcept
+        {
+            // follow growth immediately and shrink slowly
+            footprint_ = std::max(used, footprint_ - footprint_ / 4);
+
+            size_t result = InitialSize;
+            while (result < footprint_ + footprint_ / 8 && result < MaximumLearnedSize)
+            {
+                result *= 2;
+            }
+
+            return result;
+        }
+
+    private:
+        size_t footprint_ = 0;
+    };
+
+    // StatsPolicy receives allocation events, see NullArenaStats and ArenaStats
+    // GrowthPolicy decides sizes of pool blocks, see GeometricGrowth
+    template <typename StatsPolicy = NullArenaStats, typename GrowthPolicy = GeometricGrowth<>>
+    class BasicHeapGrowableMemoryProvider : private StatsPolicy, private GrowthPolicy
+    {
+        struct Block;
+
+    public:
+        BasicHeapGrowableMemoryProvider() {}
+        // sz overrides capacity of the first pool block
+        BasicHeapGrowableMemoryProvider(size_t sz)
+            : next_block_sz_(sz + sizeof(Block)) {}
+
+        EDSLIB_DISABLE_COPYMOVE(BasicHeapGrowableMemoryProvider)
+
+        ~BasicHeapGrowableMemoryProvider()
         {
             Clear();
         }
 
-        void* Allocate(size_t sz)
+        void* Allocate(size_t sz, size_t align = kDefaultAlignment)
         {
-            if (sz > kBigChunkThreshold)
+            StatsPolicy::OnAllocate(sz);
+            if (sz + detail::WorstPadding(align) > GrowthPolicy::kBigChunkThreshold)
             {
                 // big chunk of memory should be allocated directly from allocater
-                return AllocBigChunk(sz);
+                return AllocBigChunk(sz, align);
             }
             else
             {
                 // small chunk should be allocated from the internal pool
-                return AllocSmallChunk(sz);
+                return AllocSmallChunk(sz, align);
             }
         }
 
         void Clear() noexcept
         {
+            size_t pool_used = 0;
+            for (auto p = pooled_head_; p != nullptr; p = p->next)
+            {
+                pool_used += p->offset;
+            }
+            next_block_sz_ = GrowthPolicy::OnClear(pool_used, next_block_sz_);
+
             FreeBlocks(pooled_head_);
             FreeBlocks(big_node_);
 
             pooled_head_    = nullptr;
             pooled_current_ = nullptr;
+            pooled_tail_    = nullptr;
             big_node_       = nullptr;
+
+            byte_allocated_ = 0;
+            byte_used_      = 0;
+        }
+
+        // NOTE space that was still free in blocks between the current and the last one
+        //      when marking is not reclaimed by Rewind
+        struct Marker
+        {
+            Block* current;
+            size_t current_offset;
+            Block* tail;
+            size_t tail_offset;
+            Block* big_node;
+        };
+
+        Marker Mark() const noexcept
+        {
+            return Marker{
+                pooled_current_, pooled_current_ ? pooled_current_->offset : 0,
+                pooled_tail_, pooled_tail_ ? pooled_tail_->offset : 0,
+                big_node_};
+        }
+
+        void Rewind(const Marker& marker) noexcept
+        {
+            // big chunks allocated after the mark cannot be reused, release them
+            while (big_node_ != marker.big_node)
+            {
+                auto next = big_node_->next;
+
+                byte_allocated_ -= big_node_->size;
+                byte_used_ -= big_node_->size;
+                BlockRecycler::Deallocate(big_node_, sizeof(Block) + big_node_->size);
+                big_node_ = next;
+            }
+
+            // pool blocks appended after the mark are kept for later allocations
+            auto fresh = marker.tail == nullptr ? pooled_head_ : marker.tail->next;
+            for (auto p = fresh; p != nullptr; p = p->next)
+            {
+                byte_used_ -= p->offset;
+                p->offset  = 0;
+                p->counter = 0;
+            }
+
+            if (marker.tail != nullptr)
+            {
+                byte_used_ -= marker.tail->offset - marker.tail_offset;
+                marker.tail->offset = marker.tail_offset;
+
+                byte_used_ -= marker.current->offset - marker.current_offset;
+                marker.current->offset = marker.current_offset;
+            }
+
+            pooled_current_ = marker.current != nullptr ? marker.current : pooled_head_;
+        }
+
+        // grow the last allocation of the current or the last pool block in place if possible
+        bool TryExtend(void* p, size_t old_sz, size_t new_sz) noexcept
+        {
+            if (new_sz > GrowthPolicy::kBigChunkThreshold)
+            {
+                return false;
+            }
+
+            for (auto block : {pooled_current_, pooled_tail_})
+            {
+                if (block != nullptr && block->offset >= old_sz &&
+                    p == block->DataAddress() + block->offset - old_sz)
+                {
+                    if (block->offset - old_sz + new_sz > block->size)
+                    {
+                        return false;
+                    }
+
+                    block->offset = block->offset - old_sz + new_sz;
+                    byte_used_    = byte_used_ - old_sz + new_sz;
+                    StatsPolicy::OnUsage(byte_used_, byte_allocated_);
+                    return true;
+                }
+            }
+
+            return false;
         }
 
         size_t GetByteAllocated() const noexcept
         {
-            return CalculateUsage(pooled_head_, false) + CalculateUsage(big_node_, false);
+            return byte_allocated_;
         }
 
         size_t GetByteUsed() const noexcept
         {
-            return CalculateUsage(pooled_head_, true) + CalculateUsage(big_node_, true);
+            return byte_used_;
+        }
+
+        const StatsPolicy& GetStats() const noexcept
+        {
+            return *this;
+        }
+
+        GrowthPolicy& GetGrowthPolicy() noexcept
+        {
+            return *this;
         }
 
     private:
@@ -176,17 +555,12 @@ namespace eds
             }
         };
 
-        static constexpr size_t kFailureToleranceCount   = 8;
         static constexpr size_t kFailureCounterThreshold = 1024;
-        static constexpr size_t kBigChunkThreshold       = 2048;
-        static constexpr size_t kDefaultPoolBlockSize    = 4096 - sizeof(Block);
-        static constexpr size_t kMaximumPoolBlockSize    = 16 * 4096 - sizeof(Block);
-        static constexpr float kPoolBlockGrowthFactor    = 2;
 
         Block* NewBlock(size_t capacity)
         {
-            // allocate memory
-            void* p      = malloc(sizeof(Block) + capacity);
+            // allocate memory, pool blocks are likely to be served by the recycler
+            void* p      = BlockRecycler::Allocate(sizeof(Block) + capacity);
             Block* block = reinterpret_cast<Block*>(p);
 
             // initialize block
@@ -195,15 +569,18 @@ namespace eds
             block->offset  = 0;
             block->counter = 0;
 
+            byte_allocated_ += capacity;
             return block;
         }
 
         Block* NewPoolBlock()
         {
-            auto size  = next_block_sz_;
-            auto block = NewBlock(size);
-            next_block_sz_ =
-                std::min(static_cast<size_t>(kPoolBlockGrowthFactor * size), kMaximumPoolBlockSize);
+            // block sizes are counted with the header so that pool blocks stay in recyclable sizes
+            // any pool block must be large enough to serve the largest small chunk
+            auto size      = std::max(next_block_sz_ != 0 ? next_block_sz_ : GrowthPolicy::InitialBlockSize(),
+                                      sizeof(Block) + GrowthPolicy::kBigChunkThreshold);
+            auto block     = NewBlock(size - sizeof(Block));
+            next_block_sz_ = GrowthPolicy::NextBlockSize(size);
 
             return block;
         }
@@ -215,35 +592,17 @@ namespace eds
             {
                 auto next = p->next;
 
-                free(p);
+                BlockRecycler::Deallocate(p, sizeof(Block) + p->size);
                 p = next;
             }
         }
 
-        size_t CalculateUsage(Block* list, bool used) const
-        {
-            size_t sum = 0;
-            for (Block* p = list; p != nullptr; p = p->next)
-            {
-                if (used)
-                {
-                    sum += p->offset;
-                }
-                else
-                {
-                    sum += p->size;
-                }
-            }
-
-            return sum;
-        }
-
-        void* AllocSmallChunk(size_t sz)
+        void* AllocSmallChunk(size_t sz, size_t align)
         {
             // lazy initialization
             if (pooled_current_ == nullptr)
             {
-                pooled_head_ = pooled_current_ = NewPoolBlock();
+                pooled_head_ = pooled_current_ = pooled_tail_ = NewPoolBlock();
             }
 
             // find a chunk of memory in the memory pool
@@ -251,11 +610,15 @@ namespace eds
             while (true)
             {
                 size_t available_sz = cur->size - cur->offset;
-                if (available_sz >= sz)
+                size_t padding      = PaddingToAlign(cur->DataAddress() + cur->offset, align);
+                if (available_sz >= sz + padding)
                 {
                     // enough memory in the current Block
-                    void* addr = cur->DataAddress() + cur->offset;
-                    cur->offset += sz;
+                    void* addr = cur->DataAddress() + cur->offset + padding;
+                    cur->offset += padding + sz;
+
+                    byte_used_ += padding + sz;
+                    StatsPolicy::OnUsage(byte_used_, byte_allocated_);
                     return addr;
                 }
                 else
@@ -267,10 +630,11 @@ namespace eds
                     }
 
                     // roll to next Block, allocate one if neccessary
-                    Block* next = cur->next != nullptr ? cur->next : (cur->next = NewPoolBlock());
+                    Block* next = cur->next != nullptr ? cur->next : (pooled_tail_ = cur->next = NewPoolBlock());
                     // if the current Block has beening failing for too many times, drop it
-                    if (cur->counter > kFailureToleranceCount)
+                    if (cur->counter > GrowthPolicy::kFailureToleranceCount)
                     {
+                        StatsPolicy::OnBlockAbandoned(cur->size - cur->offset);
                         pooled_current_ = next;
                     }
 
@@ -279,36 +643,194 @@ namespace eds
             }
         }
 
-        void* AllocBigChunk(size_t sz)
+        void* AllocBigChunk(size_t sz, size_t align)
         {
             // note this works even if big_node_ == nullptr
-            Block* cur = NewBlock(sz);
-            cur->next  = big_node_;
-            big_node_  = cur;
-
-            return cur->DataAddress();
+            auto size   = sz + detail::WorstPadding(align);
+            Block* cur  = NewBlock(size);
+            cur->next   = big_node_;
+            cur->offset = size;
+            big_node_   = cur;
+
+            byte_used_ += size;
+            StatsPolicy::OnBigChunk(size);
+            StatsPolicy::OnUsage(byte_used_, byte_allocated_);
+            return cur->DataAddress() + PaddingToAlign(cur->DataAddress(), align);
         }
 
     private:
-        size_t next_block_sz_ = kDefaultPoolBlockSize;
+        // size of the next pool block, 0 if the initial size of the growth policy should be used
+        size_t next_block_sz_ = 0;
 
         // blocks for memory pool
         Block* pooled_head_    = nullptr;
         Block* pooled_current_ = nullptr;
+        Block* pooled_tail_    = nullptr;
         // blocks for big chunk allocation
         Block* big_node_ = nullptr;
+
+        // running counters of all blocks
+        size_t byte_allocated_ = 0;
+        size_t byte_used_      = 0;
+    };
+
+    using HeapGrowableMemoryProvider = BasicHeapGrowableMemoryProvider<>;
+
+    // WorkspaceSpillStats tells how often a hybrid workspace had to fall back to the heap
+    struct WorkspaceSpillStats
+    {
+        // allocations served by the fallback provider
+        size_t spill_count = 0;
+        size_t spill_bytes = 0;
+        // Clear calls, and those of them ending a cycle that spilled
+        size_t cycle_count         = 0;
+        size_t spilled_cycle_count = 0;
+    };
+
+    // A workspace provider that serves from an inline buffer first and spills to a fallback
+    // provider once the buffer is exhausted, so outliers cost a heap allocation instead of a nullptr
+    //
+    // sz is forwarded to the fallback provider
+    template <size_t BufferSize = kDefaultWorkspaceSize, typename FallbackProvider = HeapGrowableMemoryProvider>
+    class HybridWorkspaceMemoryProvider
+    {
+    public:
+        HybridWorkspaceMemoryProvider() {}
+        HybridWorkspaceMemoryProvider(size_t sz)
+            : fallback_(sz) {}
+
+        EDSLIB_DISABLE_COPYMOVE(HybridWorkspaceMemoryProvider)
+
+        void* Allocate(size_t sz, size_t align = kDefaultAlignment)
+        {
+            auto offset = offset_ + PaddingToAlign(&buffer_[offset_], align);
+            if (offset <= BufferSize && sz <= BufferSize - offset)
+            {
+                void* result = &buffer_[offset];
+                offset_      = offset + sz;
+
+                return result;
+            }
+
+            return Spill(sz, align);
+        }
+
+        void Clear() noexcept
+        {
+            stats_.cycle_count += 1;
+            if (spilled_)
+            {
+                stats_.spilled_cycle_count += 1;
+                fallback_.Clear();
+            }
+
+            offset_  = 0;
+            spilled_ = false;
+        }
+
+        struct Marker
+        {
+            size_t offset;
+            typename FallbackProvider::Marker fallback;
+        };
+
+        Marker Mark() const noexcept
+        {
+            return Marker{offset_, fallback_.Mark()};
+        }
+
+        void Rewind(const Marker& marker) noexcept
+        {
+            assert(marker.offset <= offset_);
+            offset_ = marker.offset;
+            fallback_.Rewind(marker.fallback);
+        }
+
+        // grow the last allocation in the buffer or in the fallback provider in place if possible
+        bool TryExtend(void* p, size_t old_sz, size_t new_sz) noexcept
+        {
+            if (old_sz <= offset_ && p == &buffer_[offset_ - old_sz])
+            {
+                if (offset_ - old_sz + new_sz > BufferSize)
+                {
+                    return false;
+                }
+
+                offset_ = offset_ - old_sz + new_sz;
+                return true;
+            }
+
+            return fallback_.TryExtend(p, old_sz, new_sz);
+        }
+
+        size_t GetByteAllocated() const noexcept
+        {
+            return BufferSize + fallback_.GetByteAllocated();
+        }
+
+        size_t GetByteUsed() const noexcept
+        {
+            return offset_ + fallback_.GetByteUsed();
+        }
+
+        const WorkspaceSpillStats& GetSpillStats() const noexcept
+        {
+            return stats_;
+        }
+
+    private:
+        void* Spill(size_t sz, size_t align)
+        {
+            auto result = fallback_.Allocate(sz, align);
+            if (result != nullptr)
+            {
+                stats_.spill_count += 1;
+                stats_.spill_bytes += sz;
+                spilled_ = true;
+            }
+
+            return result;
+        }
+
+        alignas(kDefaultAlignment) uint8_t buffer_[BufferSize];
+        size_t offset_ = 0;
+
+        // if the fallback provider has been used since last Clear
+        bool spilled_ = false;
+        FallbackProvider fallback_;
+
+        WorkspaceSpillStats stats_;
     };
 
-    template <typename MemoryProvider, size_t AlignmentSize = alignof(std::max_align_t)>
+    namespace detail
+    {
+        // providers declaring kConcurrent = true could be allocated from by multiple threads
+        template <typename T, typename = void>
+        struct IsConcurrentProvider : std::false_type
+        {
+        };
+        template <typename T>
+        struct IsConcurrentProvider<T, std::void_t<decltype(T::kConcurrent)>>
+            : std::bool_constant<T::kConcurrent>
+        {
+        };
+    } // namespace detail
+
+    // BasicArena allocates memory from MemoryProvider and destroys objects constructed in it on Clear
+    //
+    // untyped allocations are aligned to AlignmentSize while objects are packed at their natural alignment
+    template <typename MemoryProvider, size_t AlignmentSize = kDefaultAlignment>
     class BasicArena final : MemoryProvider
     {
     public:
-        static_assert(AlignmentSize >= alignof(std::max_align_t));
+        static_assert(AlignmentSize >= kDefaultAlignment && (AlignmentSize & (AlignmentSize - 1)) == 0);
 
         using Ptr       = std::unique_ptr<BasicArena>;
         using SharedPtr = std::shared_ptr<BasicArena>;
 
         BasicArena() {}
+        explicit BasicArena(size_t sz)
+            : MemoryProvider(sz) {}
 
         EDSLIB_DISABLE_COPYMOVE(BasicArena);
 
@@ -319,16 +841,28 @@ namespace eds
 
         void* Allocate(size_t sz) noexcept
         {
-            return MemoryProvider::Allocate(RoundToAlign(sz, AlignmentSize));
+            return MemoryProvider::Allocate(sz, AlignmentSize);
+        }
+
+        // allocate sz bytes aligned to align, which must be a power of 2
+        void* AllocateAligned(size_t sz, size_t align) noexcept
+        {
+            assert(align != 0 && (align & (align - 1)) == 0);
+
+            return MemoryProvider::Allocate(sz, align);
+        }
+
+        // try to grow memory at p, which must be the most recent allocation, from old_sz to new_sz bytes
+        // returns false and leaves the arena untouched if it cannot be done in place
+        bool TryExtend(void* p, size_t old_sz, size_t new_sz) noexcept
+        {
+            return MemoryProvider::TryExtend(p, old_sz, new_sz);
         }
 
         template <typename T, typename... TArgs>
         T* Construct(TArgs&&... args)
         {
-            static_assert(alignof(T) <= AlignmentSize);
-
-            constexpr auto alloc_size = CalcAllocSize<T>();
-            auto ptr                  = MemoryProvider::Allocate(alloc_size);
+            auto ptr = MemoryProvider::Allocate(CalcAllocSize<T>(), CalcAllocAlign<T>());
             if (ptr == nullptr)
             {
                 return nullptr;
@@ -343,29 +877,92 @@ namespace eds
             else
             {
                 auto handle_ptr = reinterpret_cast<DestructionHandle*>(ptr);
-                auto object_ptr = GetObjectPtr(handle_ptr);
+                auto object_ptr = AdvancePtr(ptr, GetObjectOffset<T>());
 
                 new (object_ptr) T(std::forward<TArgs>(args)...);
 
-                handle_ptr->next     = head_;
-                handle_ptr->destruct = [](void* p) { reinterpret_cast<T*>(p)->~T(); };
-                head_                = handle_ptr;
+                handle_ptr->destruct = [](DestructionHandle* handle) {
+                    reinterpret_cast<T*>(AdvancePtr(handle, GetObjectOffset<T>()))->~T();
+                };
+                PushHandle(handle_ptr);
 
                 return reinterpret_cast<T*>(object_ptr);
             }
         }
 
-        void Clear()
+        // construct an array of n objects, each of which is constructed from args
+        // only one destruction record is kept for the whole array
+        template <typename T, typename... TArgs>
+        T* ConstructArray(size_t n, const TArgs&... args)
         {
-            for (auto handle = head_; handle->next != nullptr; handle = handle->next)
-            {
-                handle->destruct(GetObjectPtr(handle));
-            }
+            return ConstructArrayInternal<T>(n, [&](T* p) {
+                size_t i = 0;
+                try
+                {
+                    for (; i < n; ++i)
+                    {
+                        new (p + i) T(args...);
+                    }
+                }
+                catch (...)
+                {
+                    std::destroy_n(p, i);
+                    throw;
+                }
+            });
+        }
+
+        // construct an array of objects copied from range [first, last)
+        // only one destruction record is kept for the whole array
+        template <typename T, typename TIter>
+        T* ConstructRange(TIter first, TIter last)
+        {
+            static_assert(type::Constraint<TIter>(type::is_iterator), "TIter must be an iterator type");
+            // the range is walked twice, once to count and once to copy
+            static_assert(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<TIter>::iterator_category>,
+                          "TIter must be a forward iterator type");
+
+            auto n = static_cast<size_t>(std::distance(first, last));
+            return ConstructArrayInternal<T>(n, [&](T* p) { std::uninitialized_copy(first, last, p); });
+        }
 
-            head_ = GetPivotHandle();
+        void Clear()
+        {
+            DestroyUntil(GetPivotHandle());
             MemoryProvider::Clear();
         }
 
+        class Checkpoint;
+
+        // capture the current state of the arena, see RewindTo
+        Checkpoint GetCheckpoint() const noexcept
+        {
+            return Checkpoint{head_, MemoryProvider::Mark()};
+        }
+
+        // destroy objects constructed after the checkpoint and reset the provider to the state
+        // when it's taken without releasing memory blocks
+        // NOTE checkpoints taken after this one, or before a Clear, are invalidated
+        void RewindTo(const Checkpoint& checkpoint)
+        {
+            DestroyUntil(checkpoint.head_);
+            MemoryProvider::Rewind(checkpoint.marker_);
+        }
+
+        size_t GetByteAllocated() const noexcept
+        {
+            return MemoryProvider::GetByteAllocated();
+        }
+
+        size_t GetByteUsed() const noexcept
+        {
+            return MemoryProvider::GetByteUsed();
+        }
+
+        MemoryProvider& GetProvider() noexcept
+        {
+            return *this;
+        }
         const MemoryProvider& GetProvider() const noexcept
         {
             return *this;
@@ -375,40 +972,172 @@ namespace eds
         struct DestructionHandle
         {
             DestructionHandle* next;
-            void (*destruct)(void*);
+            // destroy the object(s) recorded by this handle
+            void (*destruct)(DestructionHandle*);
         };
 
+    public:
+        class Checkpoint
+        {
+        private:
+            friend class BasicArena;
+
+            Checkpoint(DestructionHandle* head, typename MemoryProvider::Marker marker)
+                : head_(head), marker_(marker) {}
+
+            DestructionHandle* head_;
+            typename MemoryProvider::Marker marker_;
+        };
+
+    private:
+        // NOTE this is not thread-safe even for concurrent providers
+        void DestroyUntil(DestructionHandle* stop)
+        {
+            while (head_ != stop)
+            {
+                DestructionHandle* handle = head_;
+                head_                     = handle->next;
+
+                handle->destruct(handle);
+            }
+        }
+
         static DestructionHandle* GetPivotHandle() noexcept
         {
-            static DestructionHandle handle{nullptr, [](void*) {}};
+            static DestructionHandle handle{nullptr, [](DestructionHandle*) {}};
 
             return &handle;
         }
 
-        static void* GetObjectPtr(DestructionHandle* handle) noexcept
+        // objects are placed right after their destruction handle at their natural alignment
+        template <typename T>
+        constexpr static size_t GetObjectOffset() noexcept
+        {
+            return RoundToAlign(sizeof(DestructionHandle), alignof(T));
+        }
+
+        // arrays store their length right after the destruction handle
+        static size_t* GetArrayLengthPtr(DestructionHandle* handle) noexcept
+        {
+            return reinterpret_cast<size_t*>(handle + 1);
+        }
+
+        template <typename T>
+        constexpr static size_t GetArrayOffset() noexcept
+        {
+            return RoundToAlign(sizeof(DestructionHandle) + sizeof(size_t), alignof(T));
+        }
+
+        template <typename T, typename FInit>
+        T* ConstructArrayInternal(size_t n, FInit init)
         {
-            return AdvancePtr(handle, RoundToAlign(sizeof(DestructionHandle), AlignmentSize));
+            if constexpr (std::is_trivially_destructible_v<T>)
+            {
+                auto ptr = MemoryProvider::Allocate(detail::ArrayAllocSize<T>(n), alignof(T));
+                if (ptr == nullptr)
+                {
+                    return nullptr;
+                }
+
+                init(reinterpret_cast<T*>(ptr));
+                return reinterpret_cast<T*>(ptr);
+            }
+            else
+            {
+                auto ptr = MemoryProvider::Allocate(detail::ArrayAllocSize<T>(n, GetArrayOffset<T>()), CalcAllocAlign<T>());
+                if (ptr == nullptr)
+                {
+                    return nullptr;
+                }
+
+                auto handle_ptr = reinterpret_cast<DestructionHandle*>(ptr);
+                auto array_ptr  = reinterpret_cast<T*>(AdvancePtr(ptr, GetArrayOffset<T>()));
+
+                init(array_ptr);
+
+                *GetArrayLengthPtr(handle_ptr) = n;
+                handle_ptr->destruct           = [](DestructionHandle* handle) {
+                    auto length = *GetArrayLengthPtr(handle);
+                    auto array  = reinterpret_cast<T*>(AdvancePtr(handle, GetArrayOffset<T>()));
+
+                    // destroy in reverse order as built-in arrays do
+                    for (auto i = length; i > 0; --i)
+                    {
+                        array[i - 1].~T();
+                    }
+                };
+                PushHandle(handle_ptr);
+
+                return array_ptr;
+            }
         }
 
         template <typename T>
         constexpr static size_t CalcAllocSize() noexcept
         {
-            constexpr auto aligned_size = RoundToAlign(sizeof(T), AlignmentSize);
+            if constexpr (std::is_trivially_destructible_v<T>)
+            {
+                return sizeof(T);
+            }
+            else
+            {
+                return GetObjectOffset<T>() + sizeof(T);
+            }
+        }
 
+        template <typename T>
+        constexpr static size_t CalcAllocAlign() noexcept
+        {
             if constexpr (std::is_trivially_destructible_v<T>)
             {
-                return aligned_size;
+                return alignof(T);
             }
             else
             {
-                return aligned_size + RoundToAlign(sizeof(DestructionHandle), AlignmentSize);
+                return std::max(alignof(T), alignof(DestructionHandle));
             }
         }
 
-        DestructionHandle* head_ = GetPivotHandle();
+        void PushHandle(DestructionHandle* handle) noexcept
+        {
+            if constexpr (kConcurrent)
+            {
+                handle->next = head_.load(std::memory_order_relaxed);
+                while (!head_.compare_exchange_weak(handle->next, handle, std::memory_order_release, std::memory_order_relaxed))
+                {
+                }
+            }
+            else
+            {
+                handle->next = head_;
+                head_        = handle;
+            }
+        }
+
+        static constexpr bool kConcurrent = detail::IsConcurrentProvider<MemoryProvider>::value;
+
+        std::conditional_t<kConcurrent, std::atomic<DestructionHandle*>, DestructionHandle*> head_{GetPivotHandle()};
     };
 
-    using Workspace = BasicArena<StackWorkspaceMemoryProvider<>>;
-    using Arena     = BasicArena<HeapGrowableMemoryProvider>;
+    namespace detail
+    {
+        // allocate storage for n objects of T from an arena, throw std::bad_alloc on failure
+        // like a standard allocator does
+        template <typename T, typename TArena>
+        inline T* AllocateFromArena(TArena& arena, size_t n = 1)
+        {
+            auto p = arena.AllocateAligned(ArrayAllocSize<T>(n), alignof(T));
+            if (p == nullptr)
+            {
+                throw std::bad_alloc{};
+            }
+
+            return reinterpret_cast<T*>(p);
+        }
+    } // namespace detail
+
+    using Workspace          = BasicArena<StackWorkspaceMemoryProvider<>>;
+    using SpillableWorkspace = BasicArena<HybridWorkspaceMemoryProvider<>>;
+    using Arena              = BasicArena<HeapGrowableMemoryProvider>;
 
 } // namespace eds
\ No newline at end of file
@@ -0,0 +1,318 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+namespace eds
+{
+    // BlockRecycler keeps freed memory blocks of power-of-two sizes in [kMinimumSize, kMaximumSize]
+    // so that arenas could be cleared and refilled without going back to the global allocator
+    //
+    // blocks are first cached in a thread-local list, overflow is handed over to a global
+    // lock-free stack in batches. the global stack is only ever pushed to or taken as a whole,
+    // so it's free from ABA problem
+    //
+    // NOTE once the thread cache of a thread is destroyed, blocks are allocated and freed directly
+    //      on that thread, e.g. by arenas of static storage duration destroyed after main returns.
+    //      the global pool is not touched then, as it may be destroyed already
+    class BlockRecycler
+    {
+    public:
+        static constexpr size_t kMinimumSize = 4096;
+        static constexpr size_t kMaximumSize = 16 * 4096;
+        static constexpr size_t kClassCount  = 5;
+
+        static constexpr size_t kDefaultThreadCacheLimit = 16;
+        static constexpr size_t kDefaultGlobalLimit      = 256;
+
+        // test if blocks of size sz could be recycled
+        static constexpr bool IsRecyclable(size_t sz) noexcept
+        {
+            return sz >= kMinimumSize && sz <= kMaximumSize && (sz & (sz - 1)) == 0;
+        }
+
+        // allocate a block of sz bytes, reusing a cached one if possible
+        static void* Allocate(size_t sz)
+        {
+            if (!IsRecyclable(sz) || thread_cache_destroyed_)
+            {
+                return malloc(sz);
+            }
+
+            auto& cache = GetThreadCache().lists[GetClassIndex(sz)];
+            if (cache.head == nullptr)
+            {
+                RefillThreadCache(cache, GetGlobalPool().lists[GetClassIndex(sz)]);
+            }
+
+            if (cache.head != nullptr)
+            {
+                auto result = cache.head;
+                cache.head  = result->next;
+                cache.count -= 1;
+
+                return result;
+            }
+
+            return malloc(sz);
+        }
+
+        // return a block previously allocated with the same size
+        static void Deallocate(void* p, size_t sz) noexcept
+        {
+            if (!IsRecyclable(sz) || thread_cache_destroyed_)
+            {
+                free(p);
+                return;
+            }
+
+            auto& cache = GetThreadCache().lists[GetClassIndex(sz)];
+            auto limit  = thread_cache_limit_.load(std::memory_order_relaxed);
+            if (cache.count >= limit)
+            {
+                FlushThreadCache(cache, GetGlobalPool().lists[GetClassIndex(sz)], limit / 2);
+            }
+
+            if (cache.count < limit)
+            {
+                auto node   = reinterpret_cast<FreeBlock*>(p);
+                node->next  = cache.head;
+                cache.head  = node;
+                cache.count += 1;
+            }
+            else
+            {
+                free(p);
+            }
+        }
+
+        // maximum number of blocks retained per size class in each thread
+        static void SetThreadCacheLimit(size_t count) noexcept
+        {
+            thread_cache_limit_.store(count, std::memory_order_relaxed);
+        }
+
+        // maximum number of blocks retained per size class in the global pool
+        static void SetGlobalLimit(size_t count) noexcept
+        {
+            global_limit_.store(count, std::memory_order_relaxed);
+        }
+
+        // approximate count of blocks of size sz retained by the global pool
+        static size_t GetGlobalCount(size_t sz) noexcept
+        {
+            if (!IsRecyclable(sz))
+            {
+                return 0;
+            }
+
+            return GetGlobalPool().lists[GetClassIndex(sz)].count.load(std::memory_order_relaxed);
+        }
+
+        // release every block cached by the calling thread and the global pool
+        static void Trim() noexcept
+        {
+            if (thread_cache_destroyed_)
+            {
+                return;
+            }
+
+            auto& thread_cache = GetThreadCache();
+            auto& global_pool  = GetGlobalPool();
+            for (size_t i = 0; i < kClassCount; ++i)
+            {
+                FreeList(thread_cache.lists[i].head);
+                thread_cache.lists[i].head  = nullptr;
+                thread_cache.lists[i].count = 0;
+
+                // other threads may be taking blocks from the list concurrently, so only blocks
+                // freed here are subtracted from the count
+                auto& shared = global_pool.lists[i];
+                auto freed   = FreeList(shared.head.exchange(nullptr, std::memory_order_acquire));
+                shared.count.fetch_sub(freed, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct LocalList
+        {
+            FreeBlock* head = nullptr;
+            size_t count    = 0;
+        };
+
+        struct SharedList
+        {
+            std::atomic<FreeBlock*> head{nullptr};
+            // approximate count of blocks in the list, only used to enforce the retention cap
+            std::atomic<size_t> count{0};
+        };
+
+        struct GlobalPool
+        {
+            SharedList lists[kClassCount];
+
+            ~GlobalPool()
+            {
+                for (auto& list : lists)
+                {
+                    FreeList(list.head.load(std::memory_order_acquire));
+                }
+            }
+        };
+
+        struct ThreadCache
+        {
+            LocalList lists[kClassCount];
+
+            ~ThreadCache()
+            {
+                // thread-local objects are destroyed before static ones, so the pool is still alive
+                auto& global_pool = GetGlobalPool();
+                for (size_t i = 0; i < kClassCount; ++i)
+                {
+                    FlushThreadCache(lists[i], global_pool.lists[i], 0);
+                }
+
+                // blocks freed on this thread afterwards, e.g. by static arenas, bypass the cache
+                thread_cache_destroyed_ = true;
+            }
+        };
+
+        static size_t GetClassIndex(size_t sz) noexcept
+        {
+            size_t index = 0;
+            for (size_t x = kMinimumSize; x < sz; x <<= 1)
+            {
+                index += 1;
+            }
+
+            return index;
+        }
+
+        static GlobalPool& GetGlobalPool() noexcept
+        {
+            static GlobalPool pool;
+
+            return pool;
+        }
+
+        static ThreadCache& GetThreadCache() noexcept
+        {
+            static thread_local ThreadCache cache;
+
+            return cache;
+        }
+
+        // returns count of blocks freed
+        static size_t FreeList(FreeBlock* list) noexcept
+        {
+            size_t count = 0;
+            while (list != nullptr)
+            {
+                auto next = list->next;
+
+                free(list);
+                list = next;
+                count += 1;
+            }
+
+            return count;
+        }
+
+        // take over the entire global list, keep what fits into the thread cache and return the rest
+        static void RefillThreadCache(LocalList& cache, SharedList& shared) noexcept
+        {
+            if (shared.head.load(std::memory_order_relaxed) == nullptr)
+            {
+                return;
+            }
+
+            auto list = shared.head.exchange(nullptr, std::memory_order_acquire);
+            while (list != nullptr && cache.count < thread_cache_limit_.load(std::memory_order_relaxed))
+            {
+                auto next   = list->next;
+                list->next  = cache.head;
+                cache.head  = list;
+                cache.count += 1;
+                shared.count.fetch_sub(1, std::memory_order_relaxed);
+
+                list = next;
+            }
+
+            if (list != nullptr)
+            {
+                auto tail = list;
+                while (tail->next != nullptr)
+                {
+                    tail = tail->next;
+                }
+
+                PushChain(shared, list, tail);
+            }
+        }
+
+        // shrink the thread cache to keep blocks by moving them into the global pool,
+        // blocks beyond the global cap are released
+        static void FlushThreadCache(LocalList& cache, SharedList& shared, size_t keep) noexcept
+        {
+            auto limit        = global_limit_.load(std::memory_order_relaxed);
+            auto shared_count = shared.count.load(std::memory_order_relaxed);
+            if (cache.count > keep && shared_count < limit)
+            {
+                // detach a chain of blocks from the thread cache
+                auto batch = std::min(cache.count - keep, limit - shared_count);
+                auto head  = cache.head;
+                auto tail  = head;
+                for (size_t i = 1; i < batch; ++i)
+                {
+                    tail = tail->next;
+                }
+
+                cache.head = tail->next;
+                cache.count -= batch;
+
+                shared.count.fetch_add(batch, std::memory_order_relaxed);
+                PushChain(shared, head, tail);
+            }
+
+            while (cache.count > keep)
+            {
+                auto next = cache.head->next;
+
+                free(cache.head);
+                cache.head = next;
+                cache.count -= 1;
+            }
+        }
+
+        static void PushChain(SharedList& shared, FreeBlock* head, FreeBlock* tail) noexcept
+        {
+            auto old_head = shared.head.load(std::memory_order_relaxed);
+            do
+            {
+                tail->next = old_head;
+            } while (!shared.head.compare_exchange_weak(old_head, head,
+                                                         std::memory_order_release,
+                                                         std::memory_order_relaxed));
+        }
+
+        static inline std::atomic<size_t> thread_cache_limit_{kDefaultThreadCacheLimit};
+        static inline std::atomic<size_t> global_limit_{kDefaultGlobalLimit};
+
+        // set once the thread cache of the calling thread is destroyed
+        static inline thread_local bool thread_cache_destroyed_ = false;
+    };
+} // namespace eds
@@ -0,0 +1,355 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/memory/arena.h"
+#include "edslib/memory/block-recycler.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace eds
+{
+    // A growable memory provider whose hot path is a single compare and add
+    //
+    // unlike HeapGrowableMemoryProvider, the cursor and the end of the current region are kept inline
+    // and a region is retired as soon as it fails to serve a request, so no block is ever scanned twice.
+    // with TailIndexSize > 0, tails of retired regions are remembered and a request that doesn't fit
+    // into the current region switches to the best fitting tail before a new block is started
+    template <typename GrowthPolicy = GeometricGrowth<>, size_t TailIndexSize = 0>
+    class BumpMemoryProvider : private GrowthPolicy
+    {
+        struct Block;
+
+    public:
+        BumpMemoryProvider() {}
+        // sz overrides capacity of the first block
+        BumpMemoryProvider(size_t sz)
+            : next_block_sz_(sz + sizeof(Block)) {}
+
+        EDSLIB_DISABLE_COPYMOVE(BumpMemoryProvider)
+
+        ~BumpMemoryProvider()
+        {
+            Clear();
+        }
+
+        // the result is never null, even for sz of 0
+        void* Allocate(size_t sz, size_t align = kDefaultAlignment)
+        {
+            // the strict comparison sends a zero-sized request at the end of a region, including
+            // the empty one before the first block, to the slow path, which starts a new region
+            auto result = cursor_ + PaddingToAlign(cursor_, align);
+            if (result < end_ && sz <= static_cast<size_t>(end_ - result))
+            {
+                cursor_ = result + sz;
+
+                return result;
+            }
+
+            return AllocateSlow(sz, align);
+        }
+
+        void Clear() noexcept
+        {
+            next_block_sz_ = GrowthPolicy::OnClear(GetByteUsed() - big_byte_used_, next_block_sz_);
+
+            FreeBlocks(current_);
+            FreeBlocks(spare_);
+            FreeBlocks(big_node_);
+
+            current_      = nullptr;
+            spare_        = nullptr;
+            big_node_     = nullptr;
+            cursor_       = nullptr;
+            end_          = nullptr;
+            region_begin_ = nullptr;
+
+            tail_count_     = 0;
+            byte_allocated_ = 0;
+            retired_used_   = 0;
+            big_byte_used_  = 0;
+        }
+
+        // NOTE block tails remembered before Rewind are dropped
+        struct Marker
+        {
+            Block* current;
+            uint8_t* cursor;
+            uint8_t* end;
+            uint8_t* region_begin;
+            Block* big_node;
+            size_t retired_used;
+            size_t big_byte_used;
+        };
+
+        Marker Mark() const noexcept
+        {
+            return Marker{current_, cursor_, end_, region_begin_, big_node_, retired_used_, big_byte_used_};
+        }
+
+        void Rewind(const Marker& marker) noexcept
+        {
+            while (big_node_ != marker.big_node)
+            {
+                auto next = big_node_->next;
+
+                byte_allocated_ -= big_node_->size;
+                BlockRecycler::Deallocate(big_node_, sizeof(Block) + big_node_->size);
+                big_node_ = next;
+            }
+
+            // blocks started after the mark are kept as spares
+            while (current_ != marker.current)
+            {
+                auto next      = current_->next;
+                current_->next = spare_;
+                spare_         = current_;
+                current_       = next;
+            }
+
+            cursor_        = marker.cursor;
+            end_           = marker.end;
+            region_begin_  = marker.region_begin;
+            tail_count_    = 0;
+            retired_used_  = marker.retired_used;
+            big_byte_used_ = marker.big_byte_used;
+        }
+
+        // grow the last allocation of the current region in place if possible
+        bool TryExtend(void* p, size_t old_sz, size_t new_sz) noexcept
+        {
+            if (old_sz > static_cast<size_t>(cursor_ - region_begin_) || p != cursor_ - old_sz ||
+                new_sz - old_sz > static_cast<size_t>(end_ - cursor_))
+            {
+                return false;
+            }
+
+            cursor_ = cursor_ - old_sz + new_sz;
+            return true;
+        }
+
+        size_t GetByteAllocated() const noexcept
+        {
+            return byte_allocated_;
+        }
+
+        size_t GetByteUsed() const noexcept
+        {
+            return retired_used_ + static_cast<size_t>(cursor_ - region_begin_) + big_byte_used_;
+        }
+
+        GrowthPolicy& GetGrowthPolicy() noexcept
+        {
+            return *this;
+        }
+
+    private:
+        struct Block
+        {
+            Block* next;
+            // size of the block
+            size_t size;
+
+            uint8_t* DataAddress()
+            {
+                return reinterpret_cast<uint8_t*>(this + 1);
+            }
+
+            uint8_t* EndAddress()
+            {
+                return DataAddress() + size;
+            }
+        };
+
+        struct Tail
+        {
+            uint8_t* cursor;
+            uint8_t* end;
+
+            size_t Size() const noexcept
+            {
+                return static_cast<size_t>(end - cursor);
+            }
+        };
+
+        // tails smaller than this are not worth remembering
+        static constexpr size_t kMinimumTailSize = 64;
+
+        static void FreeBlocks(Block* list) noexcept
+        {
+            while (list != nullptr)
+            {
+                auto next = list->next;
+
+                BlockRecycler::Deallocate(list, sizeof(Block) + list->size);
+                list = next;
+            }
+        }
+
+        Block* NewBlock(size_t capacity)
+        {
+            auto block = reinterpret_cast<Block*>(BlockRecycler::Allocate(sizeof(Block) + capacity));
+            if (block != nullptr)
+            {
+                block->next = nullptr;
+                block->size = capacity;
+
+                byte_allocated_ += capacity;
+            }
+
+            return block;
+        }
+
+        EDSLIB_NOINLINE void* AllocateSlow(size_t sz, size_t align)
+        {
+            if (sz + detail::WorstPadding(align) > GrowthPolicy::kBigChunkThreshold)
+            {
+                return AllocBigChunk(sz, align);
+            }
+
+            // retire the current region
+            retired_used_ += cursor_ - region_begin_;
+            if constexpr (TailIndexSize > 0)
+            {
+                // tails are not aligned, reserve for the worst case
+                auto tail = FindTail(sz + align - 1);
+                RememberTail(Tail{cursor_, end_});
+
+                if (tail.cursor != nullptr)
+                {
+                    return StartRegion(tail.cursor, tail.end, sz, align);
+                }
+            }
+
+            Block* block = nullptr;
+            if (spare_ != nullptr)
+            {
+                block  = spare_;
+                spare_ = spare_->next;
+            }
+            else
+            {
+                // any pool block must be large enough to serve the largest small chunk
+                auto size = std::max(next_block_sz_ != 0 ? next_block_sz_ : GrowthPolicy::InitialBlockSize(),
+                                     sizeof(Block) + GrowthPolicy::kBigChunkThreshold);
+                if ((block = NewBlock(size - sizeof(Block))) == nullptr)
+                {
+                    // keep the provider consistent, the retired region is just left behind
+                    cursor_ = end_ = region_begin_ = nullptr;
+                    return nullptr;
+                }
+
+                next_block_sz_ = GrowthPolicy::NextBlockSize(size);
+            }
+
+            block->next = current_;
+            current_    = block;
+
+            return StartRegion(block->DataAddress(), block->EndAddress(), sz, align);
+        }
+
+        void* StartRegion(uint8_t* begin, uint8_t* end, size_t sz, size_t align) noexcept
+        {
+            auto result = begin + PaddingToAlign(begin, align);
+
+            region_begin_ = begin;
+            cursor_       = result + sz;
+            end_          = end;
+
+            return result;
+        }
+
+        void* AllocBigChunk(size_t sz, size_t align)
+        {
+            auto block = NewBlock(sz + detail::WorstPadding(align));
+            if (block == nullptr)
+            {
+                return nullptr;
+            }
+
+            block->next = big_node_;
+            big_node_   = block;
+            big_byte_used_ += block->size;
+
+            return block->DataAddress() + PaddingToAlign(block->DataAddress(), align);
+        }
+
+        // take the smallest remembered tail that could serve sz bytes out of the index
+        Tail FindTail(size_t sz) noexcept
+        {
+            size_t best = tail_count_;
+            for (size_t i = 0; i < tail_count_; ++i)
+            {
+                if (tails_[i].Size() >= sz && (best == tail_count_ || tails_[i].Size() < tails_[best].Size()))
+                {
+                    best = i;
+                }
+            }
+
+            if (best == tail_count_)
+            {
+                return Tail{nullptr, nullptr};
+            }
+
+            auto result  = tails_[best];
+            tails_[best] = tails_[--tail_count_];
+            return result;
+        }
+
+        void RememberTail(Tail tail) noexcept
+        {
+            if (tail.Size() < kMinimumTailSize)
+            {
+                return;
+            }
+
+            if (tail_count_ < TailIndexSize)
+            {
+                tails_[tail_count_++] = tail;
+                return;
+            }
+
+            // replace the smallest tail if the new one is larger
+            auto smallest = std::min_element(tails_, tails_ + tail_count_, [](const Tail& lhs, const Tail& rhs) {
+                return lhs.Size() < rhs.Size();
+            });
+            if (smallest->Size() < tail.Size())
+            {
+                *smallest = tail;
+            }
+        }
+
+        // hot path state
+        uint8_t* cursor_ = nullptr;
+        uint8_t* end_    = nullptr;
+        // start of the region being bumped, either a fresh block or a reused tail
+        uint8_t* region_begin_ = nullptr;
+
+        // pool blocks in use, newest first
+        Block* current_ = nullptr;
+        // pool blocks released by Rewind
+        Block* spare_ = nullptr;
+        // blocks for big chunk allocation
+        Block* big_node_ = nullptr;
+
+        // size of the next pool block, 0 if the initial size of the growth policy should be used
+        size_t next_block_sz_ = 0;
+
+        size_t byte_allocated_ = 0;
+        // bytes used in retired regions
+        size_t retired_used_  = 0;
+        size_t big_byte_used_ = 0;
+
+        Tail tails_[TailIndexSize > 0 ? TailIndexSize : 1];
+        size_t tail_count_ = 0;
+    };
+
+    using BumpArena = BasicArena<BumpMemoryProvider<>>;
+
+} // namespace eds
@@ -0,0 +1,231 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/memory/arena.h"
+#include "edslib/memory/block-recycler.h"
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace eds
+{
+    // A memory provider that could be shared by multiple threads
+    //
+    // allocation bumps the offset of the newest block with an atomic fetch-add and
+    // installs a fresh block with CAS when it's exhausted. small requests are served
+    // from slabs cached per thread so that the shared offset is only touched once a slab
+    //
+    // NOTE Allocate is thread-safe, while Clear must not race with any other call
+    class ConcurrentMemoryProvider
+    {
+    public:
+        static constexpr bool kConcurrent = true;
+
+        ConcurrentMemoryProvider() {}
+        ConcurrentMemoryProvider(size_t sz)
+            : block_sz_(std::max(sz, kSlabSize)) {}
+
+        EDSLIB_DISABLE_COPYMOVE(ConcurrentMemoryProvider)
+
+        ~ConcurrentMemoryProvider()
+        {
+            Clear();
+        }
+
+        void* Allocate(size_t sz, size_t align = kDefaultAlignment)
+        {
+            if (sz <= kSlabAllocThreshold && align <= kDefaultAlignment)
+            {
+                return AllocFromSlab(sz, align);
+            }
+
+            // shared allocations are sized in kDefaultAlignment steps so that they stay aligned to it
+            auto size = RoundToAlign(sz + detail::WorstPadding(align), kDefaultAlignment);
+            auto p    = size > kBigChunkThreshold ? AllocBigChunk(size) : AllocShared(size);
+
+            return p != nullptr ? AdvancePtr(p, PaddingToAlign(p, align)) : nullptr;
+        }
+
+        void Clear() noexcept
+        {
+            FreeBlocks(current_.exchange(nullptr, std::memory_order_acquire));
+            FreeBlocks(big_node_.exchange(nullptr, std::memory_order_acquire));
+
+            // invalidate slabs cached by all threads
+            generation_ = NextGeneration();
+        }
+
+        size_t GetByteAllocated() const noexcept
+        {
+            return CalculateUsage(current_.load(std::memory_order_acquire), false) +
+                   CalculateUsage(big_node_.load(std::memory_order_acquire), false);
+        }
+
+        size_t GetByteUsed() const noexcept
+        {
+            return CalculateUsage(current_.load(std::memory_order_acquire), true) +
+                   CalculateUsage(big_node_.load(std::memory_order_acquire), true);
+        }
+
+    private:
+        struct alignas(std::max_align_t) Block
+        {
+            Block* next;
+            // size of the block
+            size_t size;
+            // avalible space offset, may exceed size when the block is exhausted
+            std::atomic<size_t> offset;
+
+            uint8_t* DataAddress()
+            {
+                return reinterpret_cast<uint8_t*>(this + 1);
+            }
+        };
+
+        struct Slab
+        {
+            const ConcurrentMemoryProvider* owner = nullptr;
+            uint64_t generation                   = 0;
+
+            uint8_t* cursor = nullptr;
+            uint8_t* end    = nullptr;
+        };
+
+        static constexpr size_t kBigChunkThreshold  = 2048;
+        static constexpr size_t kSlabAllocThreshold = 256;
+        static constexpr size_t kSlabSize           = 2048;
+        static constexpr size_t kSlabCacheSize      = 4;
+        static constexpr size_t kDefaultBlockSize   = 16 * 4096 - sizeof(Block);
+
+        static uint64_t NextGeneration() noexcept
+        {
+            static std::atomic<uint64_t> counter{0};
+
+            return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        static Slab& LookupSlab(const ConcurrentMemoryProvider* owner) noexcept
+        {
+            static thread_local Slab slabs[kSlabCacheSize];
+
+            return slabs[(reinterpret_cast<uintptr_t>(owner) >> 6) % kSlabCacheSize];
+        }
+
+        static Block* NewBlock(size_t capacity, size_t offset)
+        {
+            void* p      = BlockRecycler::Allocate(sizeof(Block) + capacity);
+            Block* block = reinterpret_cast<Block*>(p);
+
+            block->next = nullptr;
+            block->size = capacity;
+            new (&block->offset) std::atomic<size_t>(offset);
+
+            return block;
+        }
+
+        static void FreeBlocks(Block* list) noexcept
+        {
+            while (list != nullptr)
+            {
+                auto next = list->next;
+
+                BlockRecycler::Deallocate(list, sizeof(Block) + list->size);
+                list = next;
+            }
+        }
+
+        static size_t CalculateUsage(Block* list, bool used) noexcept
+        {
+            size_t sum = 0;
+            for (Block* p = list; p != nullptr; p = p->next)
+            {
+                sum += used ? std::min(p->offset.load(std::memory_order_relaxed), p->size) : p->size;
+            }
+
+            return sum;
+        }
+
+        void* AllocFromSlab(size_t sz, size_t align)
+        {
+            auto& slab   = LookupSlab(this);
+            auto padding = PaddingToAlign(slab.cursor, align);
+            if (slab.owner != this || slab.generation != generation_ ||
+                static_cast<size_t>(slab.end - slab.cursor) < sz + padding)
+            {
+                // the rest of the previous slab is abandoned
+                auto p = reinterpret_cast<uint8_t*>(AllocShared(kSlabSize));
+                if (p == nullptr)
+                {
+                    return nullptr;
+                }
+
+                slab.owner      = this;
+                slab.generation = generation_;
+                slab.cursor     = p;
+                slab.end        = p + kSlabSize;
+                padding         = 0;
+            }
+
+            auto result = slab.cursor + padding;
+            slab.cursor = result + sz;
+
+            return result;
+        }
+
+        void* AllocShared(size_t sz)
+        {
+            Block* block = current_.load(std::memory_order_acquire);
+            while (true)
+            {
+                if (block != nullptr)
+                {
+                    auto offset = block->offset.fetch_add(sz, std::memory_order_relaxed);
+                    if (offset + sz <= block->size)
+                    {
+                        return block->DataAddress() + offset;
+                    }
+                }
+
+                // install a new block with the allocation reserved in it
+                auto fresh  = NewBlock(block_sz_, sz);
+                fresh->next = block;
+                if (current_.compare_exchange_strong(block, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    return fresh->DataAddress();
+                }
+
+                // some other thread won the race, retry on its block
+                BlockRecycler::Deallocate(fresh, sizeof(Block) + fresh->size);
+            }
+        }
+
+        void* AllocBigChunk(size_t sz)
+        {
+            auto block  = NewBlock(sz, sz);
+            block->next = big_node_.load(std::memory_order_relaxed);
+            while (!big_node_.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+
+            return block->DataAddress();
+        }
+
+        size_t block_sz_     = kDefaultBlockSize;
+        uint64_t generation_ = NextGeneration();
+
+        // newest block for memory pool, older ones are linked after it
+        std::atomic<Block*> current_{nullptr};
+        // blocks for big chunk allocation
+        std::atomic<Block*> big_node_{nullptr};
+    };
+
+    using ConcurrentArena = BasicArena<ConcurrentMemoryProvider>;
+
+} // namespace eds
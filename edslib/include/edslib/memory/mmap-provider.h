@@ -0,0 +1,208 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/ptr-arithmetic.h"
+#include "edslib/memory/arena.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace eds
+{
+    constexpr size_t kDefaultMmapReserveSize = size_t{1} << 30;
+    constexpr size_t kMmapCommitSize         = size_t{2} << 20;
+
+    // A memory provider backed by one contiguous virtual memory reservation (POSIX only)
+    //
+    // address space of sz bytes is reserved up front and committed on demand in kMmapCommitSize
+    // steps, so allocation is a single bump pointer. Clear returns physical pages to the system
+    // with MADV_DONTNEED while keeping the reservation
+    //
+    // UseHugePages advises transparent huge pages for the reservation when available
+    // Prefault populates pages when they're committed instead of on first touch
+    template <bool UseHugePages = true, bool Prefault = false>
+    class MmapMemoryProvider
+    {
+    public:
+        MmapMemoryProvider() : MmapMemoryProvider(kDefaultMmapReserveSize) {}
+        MmapMemoryProvider(size_t sz)
+        {
+            Reserve(RoundToAlign(sz, kMmapCommitSize));
+        }
+
+        EDSLIB_DISABLE_COPYMOVE(MmapMemoryProvider)
+
+        ~MmapMemoryProvider()
+        {
+            if (base_ != nullptr)
+            {
+                munmap(base_, reserved_);
+            }
+        }
+
+        void* Allocate(size_t sz, size_t align = kDefaultAlignment) noexcept
+        {
+            // the reservation is aligned to kMmapCommitSize
+            auto offset = RoundToAlign(offset_, align);
+            if (offset > reserved_ || sz > reserved_ - offset)
+            {
+                return nullptr;
+            }
+
+            auto new_offset = offset + sz;
+            if (new_offset > committed_ && !Commit(new_offset))
+            {
+                return nullptr;
+            }
+
+            void* result = base_ + offset;
+            offset_      = new_offset;
+
+            return result;
+        }
+
+        void Clear() noexcept
+        {
+            if (committed_ > 0)
+            {
+                // pages are kept accessible and will be zero-filled on next touch
+                madvise(base_, committed_, MADV_DONTNEED);
+            }
+
+            // released pages are committed again on demand, which also prefaults them again
+            offset_    = 0;
+            committed_ = 0;
+        }
+
+        using Marker = size_t;
+
+        Marker Mark() const noexcept
+        {
+            return offset_;
+        }
+
+        void Rewind(Marker marker) noexcept
+        {
+            assert(marker <= offset_);
+            offset_ = marker;
+        }
+
+        // grow the last allocation in place if possible
+        bool TryExtend(void* p, size_t old_sz, size_t new_sz) noexcept
+        {
+            if (old_sz > offset_ || p != base_ + offset_ - old_sz)
+            {
+                return false;
+            }
+
+            offset_ -= old_sz;
+            if (Allocate(new_sz, 1) == nullptr)
+            {
+                offset_ += old_sz;
+                return false;
+            }
+
+            return true;
+        }
+
+        // start of the reservation, all allocations are at [Data(), Data() + GetByteUsed())
+        const uint8_t* Data() const noexcept
+        {
+            return base_;
+        }
+
+        size_t GetByteReserved() const noexcept
+        {
+            return reserved_;
+        }
+
+        size_t GetByteAllocated() const noexcept
+        {
+            return committed_;
+        }
+
+        size_t GetByteUsed() const noexcept
+        {
+            return offset_;
+        }
+
+    private:
+        void Reserve(size_t sz) noexcept
+        {
+            if (sz == 0)
+            {
+                return;
+            }
+
+            // over-reserve so that the range could be aligned to a huge page boundary
+            auto p = mmap(nullptr, sz + kMmapCommitSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (p == MAP_FAILED)
+            {
+                return;
+            }
+
+            auto raw     = reinterpret_cast<uintptr_t>(p);
+            auto aligned = RoundToAlign(raw, kMmapCommitSize);
+            if (aligned > raw)
+            {
+                munmap(p, aligned - raw);
+            }
+            munmap(reinterpret_cast<void*>(aligned + sz), raw + kMmapCommitSize - aligned);
+
+            base_     = reinterpret_cast<uint8_t*>(aligned);
+            reserved_ = sz;
+
+#ifdef MADV_HUGEPAGE
+            if constexpr (UseHugePages)
+            {
+                madvise(base_, reserved_, MADV_HUGEPAGE);
+            }
+#endif
+        }
+
+        bool Commit(size_t required) noexcept
+        {
+            auto new_committed = std::min(RoundToAlign(required, kMmapCommitSize), reserved_);
+            auto first         = base_ + committed_;
+            auto length        = new_committed - committed_;
+            if (mprotect(first, length, PROT_READ | PROT_WRITE) != 0)
+            {
+                return false;
+            }
+
+            if constexpr (Prefault)
+            {
+#ifdef MADV_POPULATE_WRITE
+                if (madvise(first, length, MADV_POPULATE_WRITE) != 0)
+#endif
+                {
+                    auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                    for (size_t i = 0; i < length; i += page_size)
+                    {
+                        first[i] = 0;
+                    }
+                }
+            }
+
+            committed_ = new_committed;
+            return true;
+        }
+
+        uint8_t* base_    = nullptr;
+        size_t reserved_  = 0;
+        size_t committed_ = 0;
+
+        size_t offset_ = 0;
+    };
+
+    using MmapArena = BasicArena<MmapMemoryProvider<>>;
+
+} // namespace eds
@@ -0,0 +1,195 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/ptr-arithmetic.h"
+#include "edslib/memory/arena.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <type_traits>
+
+namespace eds
+{
+    namespace detail
+    {
+        struct FreeSlot
+        {
+            FreeSlot* next;
+        };
+    } // namespace detail
+
+    // PoolAllocator keeps an intrusive free list for each size class on top of a memory provider,
+    // so freed memory could be reused in O(1) before the provider is cleared
+    //
+    // requests larger than kMaximumPooledSize are forwarded to malloc and must be deallocated
+    template <typename MemoryProvider = HeapGrowableMemoryProvider>
+    class PoolAllocator
+    {
+    public:
+        static constexpr size_t kSizeClassStep     = alignof(std::max_align_t);
+        static constexpr size_t kMaximumPooledSize = 512;
+        static constexpr size_t kSizeClassCount    = kMaximumPooledSize / kSizeClassStep;
+
+        PoolAllocator() {}
+        PoolAllocator(size_t sz)
+            : provider_(sz) {}
+
+        EDSLIB_DISABLE_COPYMOVE(PoolAllocator)
+
+        void* Allocate(size_t sz)
+        {
+            if (sz > kMaximumPooledSize)
+            {
+                return malloc(sz);
+            }
+
+            auto index = GetClassIndex(sz);
+            if (auto slot = free_lists_[index]; slot != nullptr)
+            {
+                free_lists_[index] = slot->next;
+                return slot;
+            }
+
+            return provider_.Allocate((index + 1) * kSizeClassStep);
+        }
+
+        void Deallocate(void* p, size_t sz) noexcept
+        {
+            if (sz > kMaximumPooledSize)
+            {
+                free(p);
+                return;
+            }
+
+            auto index = GetClassIndex(sz);
+            auto slot  = reinterpret_cast<detail::FreeSlot*>(p);
+
+            slot->next         = free_lists_[index];
+            free_lists_[index] = slot;
+        }
+
+        // release all pooled memory at once
+        void Clear() noexcept
+        {
+            std::fill_n(free_lists_, kSizeClassCount, nullptr);
+            provider_.Clear();
+        }
+
+        const MemoryProvider& GetProvider() const noexcept
+        {
+            return provider_;
+        }
+
+    private:
+        static size_t GetClassIndex(size_t sz) noexcept
+        {
+            return sz == 0 ? 0 : (sz - 1) / kSizeClassStep;
+        }
+
+        MemoryProvider provider_;
+        detail::FreeSlot* free_lists_[kSizeClassCount] = {};
+    };
+
+    // ObjectPool constructs objects of type T in slots taken from a memory provider,
+    // destroyed objects return their slots to a free list for reuse
+    //
+    // NOTE objects still alive when the pool is destroyed or cleared are not destructed, so those
+    //      of types that are not trivially destructible must be destroyed beforehand
+    template <typename T, typename MemoryProvider = HeapGrowableMemoryProvider>
+    class ObjectPool
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+    public:
+        ObjectPool() {}
+        ObjectPool(size_t sz)
+            : provider_(sz) {}
+
+        EDSLIB_DISABLE_COPYMOVE(ObjectPool)
+
+        ~ObjectPool()
+        {
+            assert(std::is_trivially_destructible_v<T> || live_count_ == 0);
+        }
+
+        template <typename... TArgs>
+        T* Construct(TArgs&&... args)
+        {
+            void* p = free_list_;
+            if (p != nullptr)
+            {
+                free_list_ = free_list_->next;
+            }
+            else if ((p = provider_.Allocate(kSlotSize)) == nullptr)
+            {
+                return nullptr;
+            }
+
+            try
+            {
+                new (p) T(std::forward<TArgs>(args)...);
+            }
+            catch (...)
+            {
+                ReleaseSlot(p);
+                throw;
+            }
+
+            live_count_ += 1;
+            return reinterpret_cast<T*>(p);
+        }
+
+        void Destroy(T* p) noexcept
+        {
+            assert(p != nullptr && live_count_ > 0);
+
+            p->~T();
+            ReleaseSlot(p);
+            live_count_ -= 1;
+        }
+
+        // release all slots at once, live objects are not destructed and must be trivially
+        // destructible
+        void Clear() noexcept
+        {
+            assert(std::is_trivially_destructible_v<T> || live_count_ == 0);
+
+            free_list_  = nullptr;
+            live_count_ = 0;
+            provider_.Clear();
+        }
+
+        // count of objects constructed but not yet destroyed
+        size_t Count() const noexcept
+        {
+            return live_count_;
+        }
+
+        const MemoryProvider& GetProvider() const noexcept
+        {
+            return provider_;
+        }
+
+    private:
+        static constexpr size_t kSlotSize =
+            RoundToAlign(std::max(sizeof(T), sizeof(detail::FreeSlot)), alignof(std::max_align_t));
+
+        void ReleaseSlot(void* p) noexcept
+        {
+            auto slot  = reinterpret_cast<detail::FreeSlot*>(p);
+            slot->next = free_list_;
+            free_list_ = slot;
+        }
+
+        MemoryProvider provider_;
+        detail::FreeSlot* free_list_ = nullptr;
+        size_t live_count_           = 0;
+    };
+
+} // namespace eds
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 namespace eds
@@ -31,4 +32,12 @@ namespace eds
 
 		return (sz + kAlignMask) & (~kAlignMask);
 	}
+
+	// bytes to skip from ptr so that it's aligned to alignment, which must be a power of 2
+	inline size_t PaddingToAlign(const void* ptr, size_t alignment) noexcept
+	{
+		auto addr = reinterpret_cast<uintptr_t>(ptr);
+
+		return RoundToAlign(addr, alignment) - addr;
+	}
 }
\ No newline at end of file
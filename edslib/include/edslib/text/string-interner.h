@@ -0,0 +1,193 @@
+/*=================================================================================
+*  Copyright (c) 2016 Edward Cheng
+*
+*  edslib is an open-source library in C++ and licensed under the MIT License.
+*  Refer to: https://opensource.org/licenses/MIT
+*================================================================================*/
+
+#pragma once
+#include "edslib/lang-utils.h"
+#include "edslib/memory/arena.h"
+#include "edslib/container/arena-vector.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace eds::text
+{
+    namespace detail
+    {
+        // 64-bit FNV-1a folded to 32 bits
+        inline uint32_t HashString(std::string_view s) noexcept
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (auto ch : s)
+            {
+                hash ^= static_cast<uint8_t>(ch);
+                hash *= 1099511628211ull;
+            }
+
+            return static_cast<uint32_t>(hash ^ (hash >> 32));
+        }
+    } // namespace detail
+
+    // BasicStringInterner keeps one copy of each distinct string in an arena and identifies it with
+    // a small integer id, assigned in the order strings are first seen
+    //
+    // strings are stored back to back with a terminating '\0', so views returned are stable for the
+    // lifetime of the interner and could be used as c-strings. the lookup table is open-addressed
+    // and keeps the hash of each string, so most misses are rejected without comparing characters
+    //
+    // NOTE the arena must not be cleared or rewound past the interner before it's destroyed
+    template <typename TArena = Arena>
+    class BasicStringInterner
+    {
+    public:
+        using Id = uint32_t;
+
+        static constexpr Id kInvalidId = ~Id{0};
+
+        static constexpr size_t kInitialSlotCount = 64;
+
+        explicit BasicStringInterner(TArena& arena)
+            : arena_(&arena), strings_(arena) {}
+
+        EDSLIB_DISABLE_COPYMOVE(BasicStringInterner)
+
+        // returns id of s, s is copied into the arena if it's not seen before
+        Id Intern(std::string_view s)
+        {
+            auto hash = detail::HashString(s);
+            auto slot = FindSlot(s, hash);
+            if (slot->id != kInvalidId)
+            {
+                return slot->id;
+            }
+
+            // keep load factor no more than 1/2
+            if ((strings_.size() + 1) * 2 > slot_count_)
+            {
+                Grow();
+                slot = FindSlot(s, hash);
+            }
+
+            auto data = reinterpret_cast<char*>(arena_->AllocateAligned(s.size() + 1, 1));
+            if (data == nullptr)
+            {
+                throw std::bad_alloc{};
+            }
+
+            std::copy(s.begin(), s.end(), data);
+            data[s.size()] = '\0';
+
+            auto id = static_cast<Id>(strings_.size());
+            strings_.emplace_back(data, s.size());
+            *slot = Slot{hash, id};
+
+            return id;
+        }
+
+        // returns the interned copy of s
+        std::string_view InternView(std::string_view s)
+        {
+            return strings_[Intern(s)];
+        }
+
+        // returns id of s, or kInvalidId if s is never interned
+        Id Find(std::string_view s) const noexcept
+        {
+            return slot_count_ > 0 ? FindSlot(s, detail::HashString(s))->id : kInvalidId;
+        }
+
+        std::string_view Lookup(Id id) const noexcept
+        {
+            assert(id < strings_.size());
+            return strings_[id];
+        }
+
+        // count of distinct strings interned
+        size_t Size() const noexcept
+        {
+            return strings_.size();
+        }
+
+    private:
+        struct Slot
+        {
+            uint32_t hash;
+            // kInvalidId if the slot is empty
+            Id id;
+        };
+
+        Slot* FindSlot(std::string_view s, uint32_t hash) const noexcept
+        {
+            if (slot_count_ == 0)
+            {
+                return &empty_slot_;
+            }
+
+            auto mask = slot_count_ - 1;
+            for (auto index = hash & mask;; index = (index + 1) & mask)
+            {
+                auto slot = &slots_[index];
+                if (slot->id == kInvalidId)
+                {
+                    return slot;
+                }
+
+                // only compare characters when hashes agree
+                if (slot->hash == hash)
+                {
+                    auto candidate = strings_[slot->id];
+                    if (candidate.size() == s.size() && std::memcmp(candidate.data(), s.data(), s.size()) == 0)
+                    {
+                        return slot;
+                    }
+                }
+            }
+        }
+
+        // double the table, the old table is left in the arena
+        void Grow()
+        {
+            auto old_slots = slots_;
+            auto old_count = slot_count_;
+
+            slot_count_ = std::max(kInitialSlotCount, old_count * 2);
+            slots_      = eds::detail::AllocateFromArena<Slot>(*arena_, slot_count_);
+            std::fill_n(slots_, slot_count_, Slot{0, kInvalidId});
+
+            // stored hashes are reused, no string is hashed again
+            auto mask = slot_count_ - 1;
+            for (size_t i = 0; i < old_count; ++i)
+            {
+                if (old_slots[i].id != kInvalidId)
+                {
+                    auto index = old_slots[i].hash & mask;
+                    while (slots_[index].id != kInvalidId)
+                    {
+                        index = (index + 1) & mask;
+                    }
+
+                    slots_[index] = old_slots[i];
+                }
+            }
+        }
+
+        TArena* arena_;
+
+        // string of each id, in the order they're interned
+        ArenaVector<std::string_view, TArena> strings_;
+
+        Slot* slots_       = nullptr;
+        size_t slot_count_ = 0;
+
+        // returned by FindSlot before the table is allocated
+        mutable Slot empty_slot_ = {0, kInvalidId};
+    };
+
+    using StringInterner = BasicStringInterner<>;
+
+} // namespace eds::text
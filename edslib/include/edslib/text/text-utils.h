@@ -1,6 +1,7 @@
 #pragma once
 #include <cassert>
 #include <algorithm>
+#include <string_view>
 
 namespace eds::text
 {
@@ -74,4 +75,18 @@ namespace eds::text
 
         return false;
     }
+
+    // consume the longest prefix whose characters satisfy pred, returns the consumed text
+    // the view refers to the source so it could be interned without copy
+    template <typename FPred>
+    inline std::string_view ConsumeWhile(zstring& s, FPred pred)
+    {
+        auto begin = s;
+        while (*s && pred(*s))
+        {
+            ++s;
+        }
+
+        return std::string_view(begin, s - begin);
+    }
 }
\ No newline at end of file